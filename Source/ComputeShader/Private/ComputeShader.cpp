@@ -1,6 +1,7 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "ComputeShader.h"
+#include "ComputeShader/Public/PlanetComputeShader/PlanetReadbackPool.h"
 
 #include "Misc/Paths.h"
 #include "Misc/FileHelper.h"
@@ -30,6 +31,9 @@ void FComputeShader::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+
+	// The render thread is still up here to release the staging buffers, it is not once the pool itself goes away
+	FPlanetReadbackPool::Get().Trim();
 }
 
 #undef LOCTEXT_NAMESPACE
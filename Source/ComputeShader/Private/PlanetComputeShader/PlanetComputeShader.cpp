@@ -5,6 +5,7 @@
 // Material-based compute shader that evaluates terrain generation per-vertex.
 
 #include "ComputeShader/Public/PlanetComputeShader/PlanetComputeShader.h"
+#include "ComputeShader/Public/PlanetComputeShader/PlanetReadbackPool.h"
 
 #include "GlobalShader.h"
 #include "MaterialShader.h"
@@ -38,23 +39,21 @@ public:
 	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
 		// Input/Output buffers
 		SHADER_PARAMETER_RDG_BUFFER_SRV(Buffer<float3>, Input)
+		SHADER_PARAMETER_RDG_BUFFER_SRV(StructuredBuffer<FPlanetChunkDesc>, ChunkDescs)
 		SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D<float4>, BiomeMap)
 		SHADER_PARAMETER_RDG_BUFFER_UAV(RWBuffer<float>, Output)
 		SHADER_PARAMETER_RDG_BUFFER_UAV(RWBuffer<uint>, OutputVC)
+		SHADER_PARAMETER_RDG_BUFFER_UAV(RWBuffer<uint>, OutputCompact)
 		
 		// Input textures
 		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D<float4>, CurveAtlas)
 		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D<uint>, BiomeDataTexture)
 		
-		// Chunk parameters
-		SHADER_PARAMETER(FVector3f, chunkLocation)
-		SHADER_PARAMETER(FIntVector, chunkRotation)
-		SHADER_PARAMETER(FVector3f, chunkOriginLocation)
-		SHADER_PARAMETER(float, chunkSize)
+		// Planet parameters, the chunk parameters are in ChunkDescs
 		SHADER_PARAMETER(float, planetRadius)
 		SHADER_PARAMETER(float, noiseHeight)
 		SHADER_PARAMETER(uint32, biomeCount)
-		SHADER_PARAMETER(int32, chunkQuality)
+		SHADER_PARAMETER(uint32, outputFormat)
 		
 		// View uniforms (required for material evaluation)
 		SHADER_PARAMETER_STRUCT_REF(FViewUniformShaderParameters, View)
@@ -88,6 +87,293 @@ public:
 
 IMPLEMENT_MATERIAL_SHADER_TYPE(, FPlanetComputeShader, TEXT("/ComputeShaderShaders/Planet.usf"), TEXT("PlanetComputeShader"), SF_Compute);
 
+//------------------------------------------------------------------------------
+// Batch Layout
+//------------------------------------------------------------------------------
+FPlanetComputeShaderBatchLayout FPlanetComputeShaderBatchLayout::Build(TConstArrayView<FPlanetComputeShaderDispatchParams> Params)
+{
+	FPlanetComputeShaderBatchLayout Layout;
+	Layout.Chunks.Reserve(Params.Num());
+
+	for (const FPlanetComputeShaderDispatchParams& Chunk : Params)
+	{
+		Layout.MaxVertices = FMath::Max3(Layout.MaxVertices, Chunk.X, Chunk.Y);
+	}
+
+	// Every chunk gets MaxVertices * 2 atlas rows: indices on top, strengths below, like its own biome map
+	for (int32 Index = 0; Index < Params.Num(); Index++)
+	{
+		const FPlanetComputeShaderDispatchParams& Chunk = Params[Index];
+
+		FPlanetComputeShaderChunkDesc& Desc = Layout.Chunks.Add_GetRef(MakeChunkDesc(Chunk));
+		Desc.VertexOffset = Layout.TotalVertices;
+		Desc.BiomeMapRow = Index * Layout.MaxVertices * 2;
+
+		Layout.TotalVertices += Chunk.X * Chunk.Y;
+	}
+
+	Layout.BiomeMapAtlasSize = FIntPoint(Layout.MaxVertices, Layout.MaxVertices * 2 * Params.Num());
+	return Layout;
+}
+
+FPlanetComputeShaderChunkDesc FPlanetComputeShaderBatchLayout::MakeChunkDesc(const FPlanetComputeShaderDispatchParams& Params)
+{
+	FPlanetComputeShaderChunkDesc Desc;
+	Desc.ChunkLocation = Params.ChunkLocation;
+	Desc.ChunkQuality = Params.ChunkQuality;
+	Desc.ChunkRotation = Params.ChunkRotation;
+	Desc.ChunkOriginLocation = Params.ChunkOriginLocation;
+	Desc.ChunkSize = Params.ChunkSize;
+	return Desc;
+}
+
+bool FPlanetComputeShaderBatchLayout::CanBatch(const FPlanetComputeShaderDispatchParams& A, const FPlanetComputeShaderDispatchParams& B)
+{
+	return A.MaterialRenderProxy == B.MaterialRenderProxy
+		&& A.Scene == B.Scene
+		&& A.CurveAtlas == B.CurveAtlas
+		&& A.BiomeDataTexture == B.BiomeDataTexture
+		&& A.PlanetRadius == B.PlanetRadius
+		&& A.NoiseHeight == B.NoiseHeight
+		&& A.BiomeCount == B.BiomeCount
+		&& A.ReadbackFormat == B.ReadbackFormat;
+}
+
+int32 FPlanetComputeShaderBatchLayout::GetMaxBatchSize(int32 VerticesPerEdge, int32 MaxChunks)
+{
+	return FMath::Clamp(MaxAtlasHeight / FMath::Max(VerticesPerEdge * 2, 1), 1, FMath::Max(MaxChunks, 1));
+}
+
+//------------------------------------------------------------------------------
+// Readback Format
+//------------------------------------------------------------------------------
+namespace
+{
+	// TransformLocation in GenerationUtilities.usf
+	FVector TransformLocation(const FVector& TransformPos, const FIntVector& Rotation, const FVector& LocalLocation)
+	{
+		if (Rotation == FIntVector(0, -1, 0)) return FVector(LocalLocation.X, 0.0, LocalLocation.Y) + TransformPos;
+		if (Rotation == FIntVector(0, 1, 0)) return FVector(LocalLocation.X, 0.0, -LocalLocation.Y) + TransformPos;
+		if (Rotation == FIntVector(-1, 0, 0)) return FVector(0.0, LocalLocation.Y, LocalLocation.X) + TransformPos;
+		if (Rotation == FIntVector(0, 0, 1)) return FVector(LocalLocation.X, LocalLocation.Y, 0.0) + TransformPos;
+		if (Rotation == FIntVector(0, 0, -1)) return FVector(-LocalLocation.X, LocalLocation.Y, 0.0) + TransformPos;
+		if (Rotation == FIntVector(1, 0, 0)) return FVector(0.0, LocalLocation.Y, -LocalLocation.X) + TransformPos;
+		return LocalLocation + TransformPos;
+	}
+
+	template<typename T>
+	T ReadUnaligned(const uint8* Data)
+	{
+		T Value;
+		FMemory::Memcpy(&Value, Data, sizeof(T));
+		return Value;
+	}
+}
+
+int32 FPlanetComputeShaderReadbackFormat::GetBytesPerVertex(EPlanetReadbackFormat Format)
+{
+	switch (Format)
+	{
+	case EPlanetReadbackFormat::Compact16: return 3 * sizeof(uint16);
+	case EPlanetReadbackFormat::Compact24: return 2 * sizeof(uint32);
+	default: return 3 * sizeof(float) + 4 * sizeof(uint8);
+	}
+}
+
+uint32 FPlanetComputeShaderReadbackFormat::GetMaxHeightCode(EPlanetReadbackFormat Format)
+{
+	return Format == EPlanetReadbackFormat::Compact24 ? 0xFFFFFF : 0xFFFF;
+}
+
+uint32 FPlanetComputeShaderReadbackFormat::QuantizeElevation(EPlanetReadbackFormat Format, float Elevation)
+{
+	// Same rounding as WritePlanetData
+	const float Normalized = FMath::Clamp(Elevation * 0.5f + 0.5f, 0.0f, 1.0f);
+	return static_cast<uint32>(FMath::RoundToInt(Normalized * GetMaxHeightCode(Format)));
+}
+
+float FPlanetComputeShaderReadbackFormat::DequantizeElevation(EPlanetReadbackFormat Format, uint32 HeightCode)
+{
+	return static_cast<float>(static_cast<double>(HeightCode) / GetMaxHeightCode(Format) * 2.0 - 1.0);
+}
+
+FVector FPlanetComputeShaderReadbackFormat::GetVertexDirection(const FPlanetComputeShaderChunkDesc& Chunk, float PlanetRadius, int32 X, int32 Y)
+{
+	const double Size = static_cast<double>(Chunk.ChunkSize) / Chunk.ChunkQuality;
+	const double HalfOriginal = PlanetRadius / UE_DOUBLE_SQRT_2;
+
+	const FVector Local(X * Size / HalfOriginal, Y * Size / HalfOriginal, 0.0);
+	FVector CubePos = TransformLocation(FVector(Chunk.ChunkLocation) / HalfOriginal, Chunk.ChunkRotation, Local);
+
+	// Tangent deformation for a more uniform distribution on the sphere
+	const double Factor = UE_DOUBLE_PI * 0.75 * 0.25;
+	CubePos.X = FMath::Tan(CubePos.X * Factor);
+	CubePos.Y = FMath::Tan(CubePos.Y * Factor);
+	CubePos.Z = FMath::Tan(CubePos.Z * Factor);
+
+	return CubePos.GetSafeNormal();
+}
+
+void FPlanetComputeShaderReadbackFormat::Decode(
+	EPlanetReadbackFormat Format,
+	const uint8* Data,
+	const FPlanetComputeShaderChunkDesc& Chunk,
+	float PlanetRadius,
+	float NoiseHeight,
+	TArray<float>& OutPositions,
+	TArray<uint8>& OutColors)
+{
+	check(Format != EPlanetReadbackFormat::Float);
+
+	const int32 VerticesCount = Chunk.ChunkQuality + 1;
+	const int32 BytesPerVertex = GetBytesPerVertex(Format);
+	const FVector ChunkOrigin(Chunk.ChunkOriginLocation);
+
+	OutPositions.SetNumUninitialized(VerticesCount * VerticesCount * 3);
+	OutColors.SetNumUninitialized(VerticesCount * VerticesCount * 4);
+
+	for (int32 Y = 0; Y < VerticesCount; Y++)
+	{
+		for (int32 X = 0; X < VerticesCount; X++)
+		{
+			const int32 Index = X + Y * VerticesCount;
+			const uint8* Vertex = Data + Index * BytesPerVertex;
+
+			uint32 HeightCode;
+			uint8* Color = &OutColors[Index * 4];
+			if (Format == EPlanetReadbackFormat::Compact16)
+			{
+				HeightCode = ReadUnaligned<uint16>(Vertex);
+				const uint16 RG = ReadUnaligned<uint16>(Vertex + 2);
+				const uint16 BBiome = ReadUnaligned<uint16>(Vertex + 4);
+				Color[0] = RG & 0xFF;
+				Color[1] = RG >> 8;
+				Color[2] = BBiome & 0xFF;
+				Color[3] = BBiome >> 8;
+			}
+			else
+			{
+				const uint32 HeightBiome = ReadUnaligned<uint32>(Vertex);
+				const uint32 RGB = ReadUnaligned<uint32>(Vertex + 4);
+				HeightCode = HeightBiome & 0xFFFFFF;
+				Color[0] = RGB & 0xFF;
+				Color[1] = (RGB >> 8) & 0xFF;
+				Color[2] = (RGB >> 16) & 0xFF;
+				Color[3] = HeightBiome >> 24;
+			}
+
+			// Same as the Float path writes, in double instead of the shader's float
+			const FVector Direction = GetVertexDirection(Chunk, PlanetRadius, X, Y);
+			const double Radius = PlanetRadius + DequantizeElevation(Format, HeightCode) * static_cast<double>(NoiseHeight);
+			const FVector Position = Direction * Radius - ChunkOrigin;
+
+			OutPositions[Index * 3] = Position.X;
+			OutPositions[Index * 3 + 1] = Position.Y;
+			OutPositions[Index * 3 + 2] = Position.Z;
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+// Readback Mapping
+// The buffers are mapped once for the whole batch and read in place by the chunks' workers,
+// so the render thread cost of a finished chunk does not grow with its size.
+//------------------------------------------------------------------------------
+class FPlanetComputeShaderReadbackMapping
+{
+public:
+	TSharedPtr<FRHIGPUBufferReadback> OutputBuffer;
+	TSharedPtr<FRHIGPUBufferReadback> OutputVCBuffer;
+	uint32 OutputBytes = 0;
+	uint32 OutputVCBytes = 0;
+
+	// Render thread only
+	bool Map()
+	{
+		check(IsInRenderingThread());
+		if (NumMapped == 0)
+		{
+			OutputData = static_cast<const uint8*>(OutputBuffer->Lock(OutputBytes));
+			OutputVCData = OutputVCBuffer.IsValid() ? static_cast<const uint8*>(OutputVCBuffer->Lock(OutputVCBytes)) : nullptr;
+			if (OutputData == nullptr || (OutputVCBuffer.IsValid() && OutputVCData == nullptr))
+			{
+				Unlock();
+				return false;
+			}
+		}
+		NumMapped++;
+		return true;
+	}
+
+	void Unmap()
+	{
+		check(IsInRenderingThread());
+		check(NumMapped > 0);
+		if (--NumMapped == 0)
+		{
+			Unlock();
+		}
+	}
+
+	const uint8* GetOutputData() const { return OutputData; }
+	const uint8* GetOutputVCData() const { return OutputVCData; }
+
+private:
+	void Unlock()
+	{
+		if (OutputData != nullptr)
+		{
+			OutputBuffer->Unlock();
+		}
+		if (OutputVCData != nullptr)
+		{
+			OutputVCBuffer->Unlock();
+		}
+		OutputData = nullptr;
+		OutputVCData = nullptr;
+	}
+
+	int32 NumMapped = 0;
+	const uint8* OutputData = nullptr;
+	const uint8* OutputVCData = nullptr;
+};
+
+FPlanetComputeShaderMappedReadback::~FPlanetComputeShaderMappedReadback()
+{
+	if (Mapping.IsValid())
+	{
+		// Runs right away on the render thread, after the readers are done anywhere else
+		ENQUEUE_RENDER_COMMAND(PlanetReadbackUnmap)(
+			[Mapping = MoveTemp(Mapping)](FRHICommandListImmediate& RHICmdList)
+			{
+				Mapping->Unmap();
+			});
+	}
+}
+
+TSharedPtr<FPlanetComputeShaderMappedReadback> FPlanetComputeShaderReadback::Map() const
+{
+	if (!Mapping.IsValid() || NumVertices <= 0 || !Mapping->Map())
+	{
+		return nullptr;
+	}
+
+	TSharedPtr<FPlanetComputeShaderMappedReadback> Mapped = MakeShared<FPlanetComputeShaderMappedReadback>();
+	Mapped->Mapping = Mapping;
+	Mapped->Format = Format;
+	Mapped->NumVertices = NumVertices;
+	if (Format == EPlanetReadbackFormat::Float)
+	{
+		Mapped->Data = Mapping->GetOutputData() + VertexOffset * 3 * sizeof(float);
+		Mapped->ColorData = Mapping->GetOutputVCData() + VertexOffset * 4;
+	}
+	else
+	{
+		Mapped->Data = Mapping->GetOutputData() + VertexOffset * FPlanetComputeShaderReadbackFormat::GetBytesPerVertex(Format);
+	}
+	return Mapped;
+}
+
 //------------------------------------------------------------------------------
 // Dispatch Implementation
 //------------------------------------------------------------------------------
@@ -95,7 +381,32 @@ FPlanetComputeShaderReadback FPlanetComputeShaderInterface::DispatchRenderThread
 	FRHICommandListImmediate& RHICmdList, 
 	FPlanetComputeShaderDispatchParams Params)
 {
-	FPlanetComputeShaderReadback Readback;
+	// A single chunk is a batch of one
+	return DispatchBatchRenderThread(RHICmdList, MakeArrayView(&Params, 1))[0];
+}
+
+TArray<FPlanetComputeShaderReadback> FPlanetComputeShaderInterface::DispatchBatchRenderThread(
+	FRHICommandListImmediate& RHICmdList, 
+	TConstArrayView<FPlanetComputeShaderDispatchParams> BatchParams)
+{
+	TArray<FPlanetComputeShaderReadback> Readbacks;
+	Readbacks.SetNum(BatchParams.Num());
+	if (BatchParams.Num() == 0)
+	{
+		return Readbacks;
+	}
+
+	const auto RetryAll = [&Readbacks]()
+	{
+		for (FPlanetComputeShaderReadback& Readback : Readbacks)
+		{
+			Readback.bRetryDispatch = true;
+		}
+		return Readbacks;
+	};
+
+	// Material, scene and planet inputs are shared by the whole batch
+	const FPlanetComputeShaderDispatchParams& Params = BatchParams[0];
 
 	//----------------------------------------------------------------------
 	// Validate Material
@@ -105,8 +416,7 @@ FPlanetComputeShaderReadback FPlanetComputeShaderInterface::DispatchRenderThread
 	{
 		UE_LOG(LogTemp, Warning, TEXT("PlanetComputeShader: No scene available for material '%s'. Skipping dispatch."),
 			*Params.MaterialDebugName);
-		Readback.bRetryDispatch = true;
-		return Readback;
+		return RetryAll();
 	}
 
 	const FMaterialRenderProxy* MaterialRenderProxy = Params.MaterialRenderProxy;
@@ -114,8 +424,7 @@ FPlanetComputeShaderReadback FPlanetComputeShaderInterface::DispatchRenderThread
 	{
 		UE_LOG(LogTemp, Warning, TEXT("PlanetComputeShader: No material proxy available for '%s'. Skipping dispatch."),
 			*Params.MaterialDebugName);
-		Readback.bRetryDispatch = true;
-		return Readback;
+		return RetryAll();
 	}
 
 	const FMaterialRenderProxy* FallbackMaterialRenderProxy = nullptr;
@@ -126,8 +435,7 @@ FPlanetComputeShaderReadback FPlanetComputeShaderInterface::DispatchRenderThread
 	{
 		UE_LOG(LogTemp, Warning, TEXT("PlanetComputeShader: Material '%s' resolved to a fallback render proxy. Skipping dispatch."),
 			*Params.MaterialDebugName);
-		Readback.bRetryDispatch = true;
-		return Readback;
+		return RetryAll();
 	}
 
 	MaterialRenderProxy = FallbackMaterialRenderProxy ? FallbackMaterialRenderProxy : MaterialRenderProxy;
@@ -136,8 +444,7 @@ FPlanetComputeShaderReadback FPlanetComputeShaderInterface::DispatchRenderThread
 	{
 		UE_LOG(LogTemp, Warning, TEXT("PlanetComputeShader: Material '%s' is not ready on the render thread. Skipping dispatch."),
 			*Params.MaterialDebugName);
-		Readback.bRetryDispatch = true;
-		return Readback;
+		return RetryAll();
 	}
 
 	//----------------------------------------------------------------------
@@ -155,10 +462,11 @@ FPlanetComputeShaderReadback FPlanetComputeShaderInterface::DispatchRenderThread
 	{
 		UE_LOG(LogTemp, Warning, TEXT("PlanetComputeShader: Shader permutation missing for material '%s'. Ensure the Generation Material has the required usage flag and let shaders finish compiling."),
 			*Params.MaterialDebugName);
-		Readback.bRetryDispatch = true;
-		return Readback;
+		return RetryAll();
 	}
 
+	const FPlanetComputeShaderBatchLayout Layout = FPlanetComputeShaderBatchLayout::Build(BatchParams);
+
 	FRDGBuilder GraphBuilder(RHICmdList);
 	{
 		SCOPE_CYCLE_COUNTER(STAT_PlanetComputeShader_Execute);
@@ -171,10 +479,11 @@ FPlanetComputeShaderReadback FPlanetComputeShaderInterface::DispatchRenderThread
 		//----------------------------------------------------------------------
 		FPlanetComputeShader::FParameters* PassParams = GraphBuilder.AllocParameters<FPlanetComputeShader::FParameters>();
 		
-		// Register textures
-		FRDGTextureRef BiomeMapRDG = GraphBuilder.RegisterExternalTexture(
-			CreateRenderTarget(Params.BiomeMap->GetResource()->TextureRHI, TEXT("BiomeMap")));
-		PassParams->BiomeMap = GraphBuilder.CreateUAV(BiomeMapRDG);
+		// The chunks write their biome maps into one atlas, copied out to each chunk's render target after the dispatch
+		FRDGTextureRef BiomeMapAtlas = GraphBuilder.CreateTexture(
+			FRDGTextureDesc::Create2D(Layout.BiomeMapAtlasSize, PF_R8G8B8A8, FClearValueBinding::None, TexCreate_ShaderResource | TexCreate_UAV),
+			TEXT("PlanetBiomeMapAtlas"));
+		PassParams->BiomeMap = GraphBuilder.CreateUAV(BiomeMapAtlas);
 
 		FRDGTextureRef CurveAtlasRDG = GraphBuilder.RegisterExternalTexture(
 			CreateRenderTarget(Params.CurveAtlas->GetResource()->TextureRHI, TEXT("CurveAtlas")));
@@ -185,14 +494,19 @@ FPlanetComputeShaderReadback FPlanetComputeShaderInterface::DispatchRenderThread
 		PassParams->BiomeDataTexture = GraphBuilder.CreateSRV(BiomeDataRDG);
 
 		// Chunk parameters
-		PassParams->chunkLocation = Params.ChunkLocation;
-		PassParams->chunkRotation = Params.ChunkRotation;
-		PassParams->chunkOriginLocation = Params.ChunkOriginLocation;
-		PassParams->chunkSize = Params.ChunkSize;
+		FRDGBufferRef ChunkDescsBuffer = CreateStructuredBuffer(
+			GraphBuilder,
+			TEXT("PlanetChunkDescs"),
+			sizeof(FPlanetComputeShaderChunkDesc),
+			Layout.Chunks.Num(),
+			Layout.Chunks.GetData(),
+			sizeof(FPlanetComputeShaderChunkDesc) * Layout.Chunks.Num()
+		);
+		PassParams->ChunkDescs = GraphBuilder.CreateSRV(ChunkDescsBuffer);
 		PassParams->planetRadius = Params.PlanetRadius;
 		PassParams->noiseHeight = Params.NoiseHeight;
 		PassParams->biomeCount = Params.BiomeCount;
-		PassParams->chunkQuality = Params.ChunkQuality;
+		PassParams->outputFormat = static_cast<uint32>(Params.ReadbackFormat);
 		
 		// Create minimal view uniform buffer (required for material evaluation)
 		FViewUniformShaderParameters ViewParams;
@@ -207,33 +521,47 @@ FPlanetComputeShaderReadback FPlanetComputeShaderInterface::DispatchRenderThread
 		//----------------------------------------------------------------------
 		// Create Output Buffers
 		//----------------------------------------------------------------------
-		const int32 NumVertices = Params.X * Params.Y;
-		Readback.NumVertices = NumVertices;
+		// The buffers the format does not use are bound with a single element
+		const EPlanetReadbackFormat Format = Params.ReadbackFormat;
+		const bool bFloatFormat = Format == EPlanetReadbackFormat::Float;
 
-		// Position buffer: 3 floats (x,y,z) per vertex
+		// Position buffer: 3 floats (x,y,z) per vertex of every chunk
 		FRDGBufferRef OutputBuffer = GraphBuilder.CreateBuffer(
-			FRDGBufferDesc::CreateBufferDesc(sizeof(float), NumVertices * 3),
+			FRDGBufferDesc::CreateBufferDesc(sizeof(float), bFloatFormat ? Layout.TotalVertices * 3 : 1),
 			TEXT("PlanetOutputBuffer")
 		);
 		PassParams->Output = GraphBuilder.CreateUAV(FRDGBufferUAVDesc(OutputBuffer, PF_R32_FLOAT));
 
-		// Vertex color buffer: 4 bytes (RGBA) per vertex
+		// Vertex color buffer: 4 bytes (RGBA) per vertex of every chunk
 		FRDGBufferRef OutputVCBuffer = GraphBuilder.CreateBuffer(
-			FRDGBufferDesc::CreateBufferDesc(sizeof(uint8), NumVertices * 4),
+			FRDGBufferDesc::CreateBufferDesc(sizeof(uint8), bFloatFormat ? Layout.TotalVertices * 4 : 1),
 			TEXT("PlanetOutputVCBuffer")
 		);
 		PassParams->OutputVC = GraphBuilder.CreateUAV(FRDGBufferUAVDesc(OutputVCBuffer, PF_R8_UINT));
+
+		// Compact buffer: height, colors and biome index interleaved, 3 uint16s or 2 uint32s per vertex of every chunk
+		const bool bCompact16 = Format == EPlanetReadbackFormat::Compact16;
+		const uint32 CompactElementSize = bCompact16 ? sizeof(uint16) : sizeof(uint32);
+		FRDGBufferRef OutputCompactBuffer = GraphBuilder.CreateBuffer(
+			FRDGBufferDesc::CreateBufferDesc(
+				CompactElementSize,
+				bFloatFormat ? 1 : Layout.TotalVertices * FPlanetComputeShaderReadbackFormat::GetBytesPerVertex(Format) / CompactElementSize),
+			TEXT("PlanetOutputCompactBuffer")
+		);
+		PassParams->OutputCompact = GraphBuilder.CreateUAV(FRDGBufferUAVDesc(OutputCompactBuffer, bCompact16 ? PF_R16_UINT : PF_R32_UINT));
 		
 		//----------------------------------------------------------------------
 		// Dispatch Compute Shader
 		//----------------------------------------------------------------------
-		const FIntVector GroupCount = FComputeShaderUtils::GetGroupCount(
-			FIntPoint(Params.X, Params.Y), 
+		// One grid slice per chunk, threads past a smaller chunk's grid exit early
+		FIntVector GroupCount = FComputeShaderUtils::GetGroupCount(
+			FIntPoint(Layout.MaxVertices, Layout.MaxVertices), 
 			FIntPoint(16, 16)
 		);
+		GroupCount.Z = Layout.Chunks.Num();
 		
 		GraphBuilder.AddPass(
-			RDG_EVENT_NAME("PlanetComputeShader"),
+			RDG_EVENT_NAME("PlanetComputeShader (%d chunks)", Layout.Chunks.Num()),
 			PassParams,
 			ERDGPassFlags::AsyncCompute,
 			[PassParams, ComputeShader, MaterialRenderProxy, MaterialResource, LocalScene, GroupCount](FRHIComputeCommandList& RHICmdList)
@@ -265,16 +593,57 @@ FPlanetComputeShaderReadback FPlanetComputeShaderInterface::DispatchRenderThread
 			}
 		);
 
+		//----------------------------------------------------------------------
+		// Copy Biome Maps
+		//----------------------------------------------------------------------
+		for (int32 Index = 0; Index < BatchParams.Num(); Index++)
+		{
+			const FPlanetComputeShaderDispatchParams& Chunk = BatchParams[Index];
+			FRDGTextureRef BiomeMapRDG = GraphBuilder.RegisterExternalTexture(
+				CreateRenderTarget(Chunk.BiomeMap->GetResource()->TextureRHI, TEXT("BiomeMap")));
+
+			FRHICopyTextureInfo CopyInfo;
+			CopyInfo.SourcePosition = FIntVector(0, Layout.Chunks[Index].BiomeMapRow, 0);
+			CopyInfo.Size = FIntVector(Chunk.X, Chunk.Y * 2, 1);
+			AddCopyTexturePass(GraphBuilder, BiomeMapAtlas, BiomeMapRDG, CopyInfo);
+		}
+
 		//----------------------------------------------------------------------
 		// Setup Readback
 		//----------------------------------------------------------------------
-		Readback.OutputBuffer = MakeShared<FRHIGPUBufferReadback>(TEXT("PlanetOutputReadback"));
-		AddEnqueueCopyPass(GraphBuilder, Readback.OutputBuffer.Get(), OutputBuffer, 0u);
-		
-		Readback.OutputVCBuffer = MakeShared<FRHIGPUBufferReadback>(TEXT("PlanetOutputVCReadback"));
-		AddEnqueueCopyPass(GraphBuilder, Readback.OutputVCBuffer.Get(), OutputVCBuffer, 0u);
+		// One readback per buffer for the whole batch, each chunk reads its slice.
+		// They come from the pool and go back to it once the last chunk of the batch drops them.
+		FPlanetReadbackPool& ReadbackPool = FPlanetReadbackPool::Get();
+		const TSharedPtr<FPlanetComputeShaderReadbackMapping> Mapping = MakeShared<FPlanetComputeShaderReadbackMapping>();
+		if (bFloatFormat)
+		{
+			Mapping->OutputBytes = sizeof(float) * 3 * Layout.TotalVertices;
+			Mapping->OutputBuffer = ReadbackPool.Acquire(Mapping->OutputBytes, TEXT("PlanetOutputReadback"));
+			AddEnqueueCopyPass(GraphBuilder, Mapping->OutputBuffer.Get(), OutputBuffer, 0u);
+
+			Mapping->OutputVCBytes = sizeof(uint8) * 4 * Layout.TotalVertices;
+			Mapping->OutputVCBuffer = ReadbackPool.Acquire(Mapping->OutputVCBytes, TEXT("PlanetOutputVCReadback"));
+			AddEnqueueCopyPass(GraphBuilder, Mapping->OutputVCBuffer.Get(), OutputVCBuffer, 0u);
+		}
+		else
+		{
+			Mapping->OutputBytes = FPlanetComputeShaderReadbackFormat::GetBytesPerVertex(Format) * Layout.TotalVertices;
+			Mapping->OutputBuffer = ReadbackPool.Acquire(Mapping->OutputBytes, TEXT("PlanetOutputCompactReadback"));
+			AddEnqueueCopyPass(GraphBuilder, Mapping->OutputBuffer.Get(), OutputCompactBuffer, 0u);
+		}
+
+		for (int32 Index = 0; Index < BatchParams.Num(); Index++)
+		{
+			FPlanetComputeShaderReadback& Readback = Readbacks[Index];
+			Readback.OutputBuffer = Mapping->OutputBuffer;
+			Readback.OutputVCBuffer = Mapping->OutputVCBuffer;
+			Readback.Mapping = Mapping;
+			Readback.NumVertices = BatchParams[Index].X * BatchParams[Index].Y;
+			Readback.VertexOffset = Layout.Chunks[Index].VertexOffset;
+			Readback.Format = Format;
+		}
 	}
 	
 	GraphBuilder.Execute();
-	return Readback;
+	return Readbacks;
 }
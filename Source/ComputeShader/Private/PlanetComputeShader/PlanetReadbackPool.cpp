@@ -0,0 +1,203 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2026 Maciej Tkaczewski
+
+#include "ComputeShader/Public/PlanetComputeShader/PlanetReadbackPool.h"
+
+#include "RenderingThread.h"
+
+FPlanetReadbackPool& FPlanetReadbackPool::Get()
+{
+	// Shared so the readbacks handed out can tell whether the pool is still there when they come back
+	static const TSharedRef<FPlanetReadbackPool> Pool = MakeShared<FPlanetReadbackPool>();
+	return *Pool;
+}
+
+FPlanetReadbackPool::~FPlanetReadbackPool()
+{
+	// Readbacks still in use hold a weak reference only and destroy themselves once released
+	TArray<FRHIGPUBufferReadback*> Leftovers;
+	for (TPair<uint32, TArray<FRHIGPUBufferReadback*>>& Bucket : Buckets)
+	{
+		Leftovers.Append(Bucket.Value);
+	}
+	Buckets.Empty();
+	Destroy(Leftovers);
+}
+
+void FPlanetReadbackPool::SetHighWaterMark(const void* Owner, int64 InHighWaterMarkBytes)
+{
+	TArray<FRHIGPUBufferReadback*> Destroyed;
+	{
+		FScopeLock Lock(&CriticalSection);
+		OwnerHighWaterMarks.Add(Owner, FMath::Max<int64>(InHighWaterMarkBytes, 0));
+		ApplyHighWaterMark(Destroyed);
+	}
+	Destroy(Destroyed);
+}
+
+void FPlanetReadbackPool::ClearHighWaterMark(const void* Owner)
+{
+	TArray<FRHIGPUBufferReadback*> Destroyed;
+	{
+		FScopeLock Lock(&CriticalSection);
+		OwnerHighWaterMarks.Remove(Owner);
+		ApplyHighWaterMark(Destroyed);
+	}
+	Destroy(Destroyed);
+}
+
+int64 FPlanetReadbackPool::GetHighWaterMark() const
+{
+	FScopeLock Lock(&CriticalSection);
+	return HighWaterMarkBytes;
+}
+
+uint32 FPlanetReadbackPool::GetBucketSize(uint32 NumBytes)
+{
+	return FMath::RoundUpToPowerOfTwo(FMath::Max(NumBytes, 1u));
+}
+
+TSharedPtr<FRHIGPUBufferReadback> FPlanetReadbackPool::Acquire(uint32 InNumBytes, const TCHAR* DebugName)
+{
+	const uint32 NumBytes = GetBucketSize(InNumBytes);
+	FRHIGPUBufferReadback* Readback = nullptr;
+	{
+		FScopeLock Lock(&CriticalSection);
+
+		TArray<FRHIGPUBufferReadback*>* Bucket = Buckets.Find(NumBytes);
+		if (Bucket != nullptr && Bucket->Num() > 0)
+		{
+			Readback = Bucket->Pop(EAllowShrinking::No);
+			Stats.NumPooled--;
+			Stats.Hits++;
+		}
+		else
+		{
+			Stats.Misses++;
+			Stats.NumResident++;
+			Stats.BytesResident += NumBytes;
+			Stats.PeakBytesResident = FMath::Max(Stats.PeakBytesResident, Stats.BytesResident);
+		}
+	}
+
+	if (Readback == nullptr)
+	{
+		Readback = new FRHIGPUBufferReadback(DebugName);
+	}
+
+	return MakeShareable(Readback, [WeakPool = AsWeak(), NumBytes](FRHIGPUBufferReadback* Released)
+	{
+		if (const TSharedPtr<FPlanetReadbackPool> Pool = WeakPool.Pin())
+		{
+			Pool->Release(Released, NumBytes);
+		}
+		else
+		{
+			TArray<FRHIGPUBufferReadback*> Destroyed = { Released };
+			Destroy(Destroyed);
+		}
+	});
+}
+
+FPlanetReadbackPool::FStats FPlanetReadbackPool::GetStats() const
+{
+	FScopeLock Lock(&CriticalSection);
+	return Stats;
+}
+
+void FPlanetReadbackPool::Trim()
+{
+	TArray<FRHIGPUBufferReadback*> Destroyed;
+	{
+		FScopeLock Lock(&CriticalSection);
+		TrimTo(0, Destroyed);
+	}
+	Destroy(Destroyed);
+}
+
+void FPlanetReadbackPool::Release(FRHIGPUBufferReadback* Readback, uint32 NumBytes)
+{
+	TArray<FRHIGPUBufferReadback*> Destroyed;
+	{
+		FScopeLock Lock(&CriticalSection);
+
+		if (Stats.BytesResident > HighWaterMarkBytes)
+		{
+			Stats.Discards++;
+			Stats.NumResident--;
+			Stats.BytesResident -= NumBytes;
+			Destroyed.Add(Readback);
+		}
+		else
+		{
+			Buckets.FindOrAdd(NumBytes).Add(Readback);
+			Stats.NumPooled++;
+		}
+	}
+	Destroy(Destroyed);
+}
+
+void FPlanetReadbackPool::ApplyHighWaterMark(TArray<FRHIGPUBufferReadback*>& OutDestroyed)
+{
+	if (OwnerHighWaterMarks.Num() == 0)
+	{
+		HighWaterMarkBytes = DefaultHighWaterMarkBytes;
+	}
+	else
+	{
+		HighWaterMarkBytes = 0;
+		for (const TPair<const void*, int64>& OwnerHighWaterMark : OwnerHighWaterMarks)
+		{
+			HighWaterMarkBytes = FMath::Max(HighWaterMarkBytes, OwnerHighWaterMark.Value);
+		}
+	}
+	TrimTo(HighWaterMarkBytes, OutDestroyed);
+}
+
+void FPlanetReadbackPool::TrimTo(int64 MaxBytes, TArray<FRHIGPUBufferReadback*>& OutDestroyed)
+{
+	// Only pooled readbacks can go, the ones in use count until they are released
+	for (auto It = Buckets.CreateIterator(); It && Stats.BytesResident > MaxBytes; ++It)
+	{
+		TArray<FRHIGPUBufferReadback*>& Bucket = It.Value();
+		while (Bucket.Num() > 0 && Stats.BytesResident > MaxBytes)
+		{
+			OutDestroyed.Add(Bucket.Pop(EAllowShrinking::No));
+			Stats.NumPooled--;
+			Stats.NumResident--;
+			Stats.BytesResident -= It.Key();
+		}
+		if (Bucket.Num() == 0)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void FPlanetReadbackPool::Destroy(TArray<FRHIGPUBufferReadback*>& Readbacks)
+{
+	if (Readbacks.Num() == 0)
+	{
+		return;
+	}
+
+	// Staging buffers are released where they are used
+	if (IsInRenderingThread())
+	{
+		for (FRHIGPUBufferReadback* Readback : Readbacks)
+		{
+			delete Readback;
+		}
+		return;
+	}
+
+	ENQUEUE_RENDER_COMMAND(PlanetReadbackPoolDestroy)(
+		[Readbacks = MoveTemp(Readbacks)](FRHICommandListImmediate& RHICmdList)
+		{
+			for (FRHIGPUBufferReadback* Readback : Readbacks)
+			{
+				delete Readback;
+			}
+		}
+	);
+}
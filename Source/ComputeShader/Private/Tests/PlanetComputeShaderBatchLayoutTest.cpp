@@ -0,0 +1,151 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2026 Maciej Tkaczewski
+
+#include "Misc/AutomationTest.h"
+#include "ComputeShader/Public/PlanetComputeShader/PlanetComputeShader.h"
+#include "Engine/Texture2D.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace PlanetComputeShaderBatchLayoutTest
+{
+	FPlanetComputeShaderDispatchParams MakeParams(int32 VerticesPerEdge, const FVector3f& ChunkLocation)
+	{
+		FPlanetComputeShaderDispatchParams Params;
+		Params.X = VerticesPerEdge;
+		Params.Y = VerticesPerEdge;
+		Params.ChunkQuality = VerticesPerEdge - 1;
+		Params.ChunkLocation = ChunkLocation;
+		Params.ChunkRotation = FIntVector(0, 0, 1);
+		Params.ChunkOriginLocation = ChunkLocation * 1000.0f;
+		Params.ChunkSize = 250.0f;
+		Params.PlanetRadius = 1000.0f;
+		Params.NoiseHeight = 100.0f;
+		Params.BiomeCount = 4;
+		return Params;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlanetComputeShaderBatchLayoutBuildTest, "PPG.ComputeShader.BatchLayout.Build",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FPlanetComputeShaderBatchLayoutBuildTest::RunTest(const FString& Parameters)
+{
+	using namespace PlanetComputeShaderBatchLayoutTest;
+
+	// Mixed grid sizes, every chunk gets the rows of the largest one
+	const TArray<FPlanetComputeShaderDispatchParams> Params = {
+		MakeParams(17, FVector3f(1.0f, 0.0f, 0.0f)),
+		MakeParams(33, FVector3f(0.0f, 1.0f, 0.0f)),
+		MakeParams(9, FVector3f(0.0f, 0.0f, 1.0f))
+	};
+
+	const FPlanetComputeShaderBatchLayout Layout = FPlanetComputeShaderBatchLayout::Build(Params);
+	if (!TestEqual(TEXT("One descriptor per chunk"), Layout.Chunks.Num(), Params.Num()))
+	{
+		return false;
+	}
+
+	TestEqual(TEXT("MaxVertices"), Layout.MaxVertices, 33);
+	TestEqual(TEXT("TotalVertices"), Layout.TotalVertices, 17 * 17 + 33 * 33 + 9 * 9);
+	TestEqual(TEXT("BiomeMapAtlasSize"), Layout.BiomeMapAtlasSize, FIntPoint(33, 33 * 2 * 3));
+
+	const uint32 ExpectedVertexOffsets[] = { 0, 17 * 17, 17 * 17 + 33 * 33 };
+	for (int32 Index = 0; Index < Params.Num(); Index++)
+	{
+		const FPlanetComputeShaderChunkDesc& Desc = Layout.Chunks[Index];
+		TestEqual(FString::Printf(TEXT("VertexOffset of chunk %d"), Index), Desc.VertexOffset, ExpectedVertexOffsets[Index]);
+		TestEqual(FString::Printf(TEXT("BiomeMapRow of chunk %d"), Index), Desc.BiomeMapRow, static_cast<uint32>(Index * 33 * 2));
+		TestEqual(FString::Printf(TEXT("ChunkLocation of chunk %d"), Index), Desc.ChunkLocation, Params[Index].ChunkLocation);
+		TestEqual(FString::Printf(TEXT("ChunkQuality of chunk %d"), Index), Desc.ChunkQuality, Params[Index].ChunkQuality);
+		TestEqual(FString::Printf(TEXT("ChunkRotation of chunk %d"), Index), Desc.ChunkRotation, Params[Index].ChunkRotation);
+		TestEqual(FString::Printf(TEXT("ChunkOriginLocation of chunk %d"), Index), Desc.ChunkOriginLocation, Params[Index].ChunkOriginLocation);
+		TestEqual(FString::Printf(TEXT("ChunkSize of chunk %d"), Index), Desc.ChunkSize, Params[Index].ChunkSize);
+	}
+
+	const FPlanetComputeShaderBatchLayout Empty = FPlanetComputeShaderBatchLayout::Build({});
+	TestEqual(TEXT("Empty batch has no vertices"), Empty.TotalVertices, 0);
+	TestEqual(TEXT("Empty batch has no atlas"), Empty.BiomeMapAtlasSize, FIntPoint::ZeroValue);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlanetComputeShaderBatchLayoutMaxBatchSizeTest, "PPG.ComputeShader.BatchLayout.MaxBatchSize",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FPlanetComputeShaderBatchLayoutMaxBatchSizeTest::RunTest(const FString& Parameters)
+{
+	using namespace PlanetComputeShaderBatchLayoutTest;
+
+	constexpr int32 MaxAtlasHeight = FPlanetComputeShaderBatchLayout::MaxAtlasHeight;
+
+	TestEqual(TEXT("Limited by MaxChunks"), FPlanetComputeShaderBatchLayout::GetMaxBatchSize(65, 16), 16);
+	TestEqual(TEXT("Limited by the atlas height"), FPlanetComputeShaderBatchLayout::GetMaxBatchSize(65, 1000), MaxAtlasHeight / 130);
+	TestEqual(TEXT("A chunk taller than the atlas still dispatches on its own"), FPlanetComputeShaderBatchLayout::GetMaxBatchSize(MaxAtlasHeight, 16), 1);
+	TestEqual(TEXT("MaxChunks below one"), FPlanetComputeShaderBatchLayout::GetMaxBatchSize(65, 0), 1);
+	TestEqual(TEXT("Empty grid"), FPlanetComputeShaderBatchLayout::GetMaxBatchSize(0, 16), 16);
+
+	// The largest batch fits into the atlas and one more chunk would not
+	for (const int32 VerticesPerEdge : { 9, 65, 129, 257 })
+	{
+		const int32 MaxChunks = FPlanetComputeShaderBatchLayout::GetMaxBatchSize(VerticesPerEdge, MAX_int32);
+
+		TArray<FPlanetComputeShaderDispatchParams> Params;
+		Params.Init(MakeParams(VerticesPerEdge, FVector3f::ZeroVector), MaxChunks);
+		const FPlanetComputeShaderBatchLayout Layout = FPlanetComputeShaderBatchLayout::Build(Params);
+
+		TestTrue(FString::Printf(TEXT("%d chunks of %d fit into the atlas"), MaxChunks, VerticesPerEdge), Layout.BiomeMapAtlasSize.Y <= MaxAtlasHeight);
+		TestTrue(FString::Printf(TEXT("%d chunks of %d do not fit into the atlas"), MaxChunks + 1, VerticesPerEdge), Layout.BiomeMapAtlasSize.Y + VerticesPerEdge * 2 > MaxAtlasHeight);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlanetComputeShaderBatchLayoutCanBatchTest, "PPG.ComputeShader.BatchLayout.CanBatch",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FPlanetComputeShaderBatchLayoutCanBatchTest::RunTest(const FString& Parameters)
+{
+	using namespace PlanetComputeShaderBatchLayoutTest;
+
+	// CanBatch only compares the pointers, these are never dereferenced
+	static const uint8 Dummies[2] = {};
+	const FMaterialRenderProxy* const OtherProxy = reinterpret_cast<const FMaterialRenderProxy*>(&Dummies[0]);
+	const FSceneInterface* const OtherScene = reinterpret_cast<const FSceneInterface*>(&Dummies[1]);
+
+	const FPlanetComputeShaderDispatchParams Base = MakeParams(33, FVector3f::ZeroVector);
+	TestTrue(TEXT("Identical dispatches batch"), FPlanetComputeShaderBatchLayout::CanBatch(Base, Base));
+
+	// Each chunk has its own place, size and biome map
+	{
+		FPlanetComputeShaderDispatchParams Other = MakeParams(17, FVector3f(1.0f, 0.0f, 0.0f));
+		Other.ChunkRotation = FIntVector(1, 0, 0);
+		Other.ChunkSize = 500.0f;
+		Other.Random = 7;
+		Other.GameTime = 3.0f;
+		TestTrue(TEXT("Per-chunk parameters do not prevent batching"), FPlanetComputeShaderBatchLayout::CanBatch(Base, Other));
+	}
+
+	const TPair<const TCHAR*, TFunction<void(FPlanetComputeShaderDispatchParams&)>> Mismatches[] = {
+		{ TEXT("MaterialRenderProxy"), [OtherProxy](FPlanetComputeShaderDispatchParams& Params) { Params.MaterialRenderProxy = OtherProxy; } },
+		{ TEXT("Scene"), [OtherScene](FPlanetComputeShaderDispatchParams& Params) { Params.Scene = OtherScene; } },
+		{ TEXT("CurveAtlas"), [](FPlanetComputeShaderDispatchParams& Params) { Params.CurveAtlas = NewObject<UTexture2D>(); } },
+		{ TEXT("BiomeDataTexture"), [](FPlanetComputeShaderDispatchParams& Params) { Params.BiomeDataTexture = NewObject<UTexture2D>(); } },
+		{ TEXT("PlanetRadius"), [](FPlanetComputeShaderDispatchParams& Params) { Params.PlanetRadius *= 2.0f; } },
+		{ TEXT("NoiseHeight"), [](FPlanetComputeShaderDispatchParams& Params) { Params.NoiseHeight *= 2.0f; } },
+		{ TEXT("BiomeCount"), [](FPlanetComputeShaderDispatchParams& Params) { Params.BiomeCount++; } },
+		{ TEXT("ReadbackFormat"), [](FPlanetComputeShaderDispatchParams& Params) { Params.ReadbackFormat = EPlanetReadbackFormat::Compact16; } }
+	};
+
+	for (const auto& Mismatch : Mismatches)
+	{
+		FPlanetComputeShaderDispatchParams Other = Base;
+		Mismatch.Value(Other);
+		TestFalse(FString::Printf(TEXT("Different %s does not batch"), Mismatch.Key), FPlanetComputeShaderBatchLayout::CanBatch(Base, Other));
+		TestFalse(FString::Printf(TEXT("Different %s does not batch, either way round"), Mismatch.Key), FPlanetComputeShaderBatchLayout::CanBatch(Other, Base));
+	}
+
+	return true;
+}
+
+#endif
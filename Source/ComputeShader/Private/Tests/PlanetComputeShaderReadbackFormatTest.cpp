@@ -0,0 +1,190 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2026 Maciej Tkaczewski
+
+#include "Misc/AutomationTest.h"
+#include "ComputeShader/Public/PlanetComputeShader/PlanetComputeShader.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace PlanetComputeShaderReadbackFormatTest
+{
+	constexpr float PlanetRadius = 1000.0f;
+	constexpr float NoiseHeight = 100.0f;
+
+	// Even, so the middle vertex sits at the center of the face
+	constexpr int32 ChunkQuality = 4;
+	constexpr int32 VerticesCount = ChunkQuality + 1;
+	constexpr int32 NumVertices = VerticesCount * VerticesCount;
+
+	struct FFace
+	{
+		FIntVector Rotation;
+		// Root chunk corner, in cube edges from the planet center as FChunkTree::Reset places them
+		FVector Corner;
+		// Direction through the middle of the face
+		FVector Center;
+	};
+
+	const FFace Faces[] = {
+		{ FIntVector(-1, 0, 0), FVector(-0.5, -0.5, -0.5), FVector(-1.0, 0.0, 0.0) },
+		{ FIntVector(0, 0, -1), FVector(0.5, -0.5, -0.5), FVector(0.0, 0.0, -1.0) },
+		{ FIntVector(0, -1, 0), FVector(-0.5, -0.5, -0.5), FVector(0.0, -1.0, 0.0) },
+		{ FIntVector(0, 0, 1), FVector(-0.5, -0.5, 0.5), FVector(0.0, 0.0, 1.0) },
+		{ FIntVector(0, 1, 0), FVector(-0.5, 0.5, 0.5), FVector(0.0, 1.0, 0.0) },
+		{ FIntVector(1, 0, 0), FVector(0.5, -0.5, 0.5), FVector(1.0, 0.0, 0.0) }
+	};
+
+	FPlanetComputeShaderChunkDesc MakeRootChunk(const FFace& Face)
+	{
+		const float CubeEdge = PlanetRadius * 2.0f / UE_SQRT_2;
+
+		FPlanetComputeShaderChunkDesc Chunk;
+		Chunk.ChunkLocation = FVector3f(Face.Corner) * CubeEdge;
+		Chunk.ChunkRotation = Face.Rotation;
+		Chunk.ChunkQuality = ChunkQuality;
+		Chunk.ChunkSize = CubeEdge;
+		Chunk.ChunkOriginLocation = FVector3f(Face.Center) * PlanetRadius;
+		return Chunk;
+	}
+
+	// From -1 to 1 over the chunk, both ends and 0 included
+	float GetElevation(int32 Index)
+	{
+		return Index * 2.0f / (NumVertices - 1) - 1.0f;
+	}
+
+	void GetColor(int32 Index, int32 Face, uint8 OutColor[4])
+	{
+		OutColor[0] = static_cast<uint8>(Index * 7 + Face);
+		OutColor[1] = static_cast<uint8>(Index * 13 + 1);
+		OutColor[2] = static_cast<uint8>(255 - Index);
+		OutColor[3] = static_cast<uint8>((Index + Face) % 16);
+	}
+
+	// The layout WritePlanetData in the shader writes
+	TArray<uint8> Encode(EPlanetReadbackFormat Format, int32 Face)
+	{
+		TArray<uint8> Data;
+		Data.SetNumZeroed(NumVertices * FPlanetComputeShaderReadbackFormat::GetBytesPerVertex(Format));
+
+		for (int32 Index = 0; Index < NumVertices; Index++)
+		{
+			const uint32 HeightCode = FPlanetComputeShaderReadbackFormat::QuantizeElevation(Format, GetElevation(Index));
+			uint8 Color[4];
+			GetColor(Index, Face, Color);
+
+			if (Format == EPlanetReadbackFormat::Compact16)
+			{
+				const uint16 Vertex[3] = {
+					static_cast<uint16>(HeightCode),
+					static_cast<uint16>(Color[0] | Color[1] << 8),
+					static_cast<uint16>(Color[2] | Color[3] << 8)
+				};
+				FMemory::Memcpy(&Data[Index * sizeof(Vertex)], Vertex, sizeof(Vertex));
+			}
+			else
+			{
+				const uint32 Vertex[2] = {
+					HeightCode | static_cast<uint32>(Color[3]) << 24,
+					static_cast<uint32>(Color[0]) | static_cast<uint32>(Color[1]) << 8 | static_cast<uint32>(Color[2]) << 16
+				};
+				FMemory::Memcpy(&Data[Index * sizeof(Vertex)], Vertex, sizeof(Vertex));
+			}
+		}
+		return Data;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlanetComputeShaderReadbackFormatQuantizeTest, "PPG.ComputeShader.ReadbackFormat.Quantize",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FPlanetComputeShaderReadbackFormatQuantizeTest::RunTest(const FString& Parameters)
+{
+	for (const EPlanetReadbackFormat Format : { EPlanetReadbackFormat::Compact16, EPlanetReadbackFormat::Compact24 })
+	{
+		const TCHAR* FormatName = Format == EPlanetReadbackFormat::Compact16 ? TEXT("Compact16") : TEXT("Compact24");
+		const uint32 MaxCode = FPlanetComputeShaderReadbackFormat::GetMaxHeightCode(Format);
+		const float Step = 2.0f / MaxCode;
+
+		TestEqual(FString::Printf(TEXT("%s: -1 is the lowest code"), FormatName), FPlanetComputeShaderReadbackFormat::QuantizeElevation(Format, -1.0f), 0u);
+		TestEqual(FString::Printf(TEXT("%s: 0 rounds up from the middle"), FormatName), FPlanetComputeShaderReadbackFormat::QuantizeElevation(Format, 0.0f), MaxCode / 2 + 1);
+		TestEqual(FString::Printf(TEXT("%s: 1 is the highest code"), FormatName), FPlanetComputeShaderReadbackFormat::QuantizeElevation(Format, 1.0f), MaxCode);
+		TestEqual(FString::Printf(TEXT("%s: below -1 clamps"), FormatName), FPlanetComputeShaderReadbackFormat::QuantizeElevation(Format, -2.0f), 0u);
+		TestEqual(FString::Printf(TEXT("%s: above 1 clamps"), FormatName), FPlanetComputeShaderReadbackFormat::QuantizeElevation(Format, 2.0f), MaxCode);
+
+		TestEqual(FString::Printf(TEXT("%s: the lowest code is -1"), FormatName), FPlanetComputeShaderReadbackFormat::DequantizeElevation(Format, 0), -1.0f, 0.0f);
+		TestEqual(FString::Printf(TEXT("%s: the highest code is 1"), FormatName), FPlanetComputeShaderReadbackFormat::DequantizeElevation(Format, MaxCode), 1.0f, 0.0f);
+
+		for (const float Elevation : { -1.0f, -0.37f, 0.0f, 0.5f, 1.0f })
+		{
+			const uint32 HeightCode = FPlanetComputeShaderReadbackFormat::QuantizeElevation(Format, Elevation);
+			TestEqual(FString::Printf(TEXT("%s: %f survives the round trip within half a step"), FormatName, Elevation),
+				FPlanetComputeShaderReadbackFormat::DequantizeElevation(Format, HeightCode), Elevation, Step * 0.5f + UE_KINDA_SMALL_NUMBER);
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlanetComputeShaderReadbackFormatDecodeTest, "PPG.ComputeShader.ReadbackFormat.Decode",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FPlanetComputeShaderReadbackFormatDecodeTest::RunTest(const FString& Parameters)
+{
+	using namespace PlanetComputeShaderReadbackFormatTest;
+
+	for (int32 FaceIndex = 0; FaceIndex < static_cast<int32>(UE_ARRAY_COUNT(Faces)); FaceIndex++)
+	{
+		const FPlanetComputeShaderChunkDesc Chunk = MakeRootChunk(Faces[FaceIndex]);
+
+		// Golden directions: every face covers its own side of the sphere
+		const FVector Center = FPlanetComputeShaderReadbackFormat::GetVertexDirection(Chunk, PlanetRadius, ChunkQuality / 2, ChunkQuality / 2);
+		TestTrue(FString::Printf(TEXT("Face %d: middle vertex points to %s"), FaceIndex, *Faces[FaceIndex].Center.ToString()), Center.Equals(Faces[FaceIndex].Center, 1e-5));
+
+		for (const EPlanetReadbackFormat Format : { EPlanetReadbackFormat::Compact16, EPlanetReadbackFormat::Compact24 })
+		{
+			const TCHAR* FormatName = Format == EPlanetReadbackFormat::Compact16 ? TEXT("Compact16") : TEXT("Compact24");
+			const TArray<uint8> Data = Encode(Format, FaceIndex);
+
+			TArray<float> Positions;
+			TArray<uint8> Colors;
+			FPlanetComputeShaderReadbackFormat::Decode(Format, Data.GetData(), Chunk, PlanetRadius, NoiseHeight, Positions, Colors);
+			if (!TestEqual(FString::Printf(TEXT("Face %d, %s: 3 floats per vertex"), FaceIndex, FormatName), Positions.Num(), NumVertices * 3)
+				|| !TestEqual(FString::Printf(TEXT("Face %d, %s: 4 bytes per vertex"), FaceIndex, FormatName), Colors.Num(), NumVertices * 4))
+			{
+				continue;
+			}
+
+			// Half a quantization step of NoiseHeight, plus float precision at the planet radius
+			const double Tolerance = NoiseHeight / static_cast<double>(FPlanetComputeShaderReadbackFormat::GetMaxHeightCode(Format)) + 1e-3;
+
+			for (int32 Y = 0; Y < VerticesCount; Y++)
+			{
+				for (int32 X = 0; X < VerticesCount; X++)
+				{
+					const int32 Index = X + Y * VerticesCount;
+
+					const FVector Direction = FPlanetComputeShaderReadbackFormat::GetVertexDirection(Chunk, PlanetRadius, X, Y);
+					const FVector Expected = Direction * (PlanetRadius + GetElevation(Index) * static_cast<double>(NoiseHeight)) - FVector(Chunk.ChunkOriginLocation);
+					const FVector Actual(Positions[Index * 3], Positions[Index * 3 + 1], Positions[Index * 3 + 2]);
+					if (!Actual.Equals(Expected, Tolerance))
+					{
+						AddError(FString::Printf(TEXT("Face %d, %s: vertex (%d, %d) at %s, expected %s"), FaceIndex, FormatName, X, Y, *Actual.ToString(), *Expected.ToString()));
+					}
+
+					uint8 Color[4];
+					GetColor(Index, FaceIndex, Color);
+					if (FMemory::Memcmp(&Colors[Index * 4], Color, sizeof(Color)) != 0)
+					{
+						AddError(FString::Printf(TEXT("Face %d, %s: vertex (%d, %d) color %d %d %d biome %d, expected %d %d %d biome %d"), FaceIndex, FormatName, X, Y,
+							Colors[Index * 4], Colors[Index * 4 + 1], Colors[Index * 4 + 2], Colors[Index * 4 + 3], Color[0], Color[1], Color[2], Color[3]));
+					}
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+#endif
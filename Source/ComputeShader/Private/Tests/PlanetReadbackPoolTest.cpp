@@ -0,0 +1,124 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2026 Maciej Tkaczewski
+
+#include "Misc/AutomationTest.h"
+#include "ComputeShader/Public/PlanetComputeShader/PlanetReadbackPool.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Bookkeeping only, the readbacks are never copied into so no staging buffer is created
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlanetReadbackPoolReuseTest, "PPG.ComputeShader.ReadbackPool.Reuse",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FPlanetReadbackPoolReuseTest::RunTest(const FString& Parameters)
+{
+	const TSharedRef<FPlanetReadbackPool> Pool = MakeShared<FPlanetReadbackPool>();
+
+	TSharedPtr<FRHIGPUBufferReadback> A = Pool->Acquire(1000, TEXT("A"));
+	TSharedPtr<FRHIGPUBufferReadback> B = Pool->Acquire(1000, TEXT("B"));
+	TSharedPtr<FRHIGPUBufferReadback> C = Pool->Acquire(500, TEXT("C"));
+
+	FPlanetReadbackPool::FStats Stats = Pool->GetStats();
+	TestEqual(TEXT("Empty pool misses"), Stats.Misses, int64(3));
+	TestEqual(TEXT("Empty pool has no hits"), Stats.Hits, int64(0));
+	TestEqual(TEXT("Resident after the misses"), Stats.NumResident, 3);
+	TestEqual(TEXT("Bytes resident after the misses, at the bucket sizes"), Stats.BytesResident, int64(1024 + 1024 + 512));
+	TestEqual(TEXT("Nothing pooled while in use"), Stats.NumPooled, 0);
+
+	// Released into its bucket and handed out again for any size rounding up to the same power of two
+	FRHIGPUBufferReadback* const Released = A.Get();
+	A.Reset();
+	TestEqual(TEXT("Released readback is pooled"), Pool->GetStats().NumPooled, 1);
+
+	TSharedPtr<FRHIGPUBufferReadback> D = Pool->Acquire(500, TEXT("D"));
+	TSharedPtr<FRHIGPUBufferReadback> E = Pool->Acquire(900, TEXT("E"));
+	TestTrue(TEXT("Same bucket reuses the released readback"), E.Get() == Released);
+
+	Stats = Pool->GetStats();
+	TestEqual(TEXT("Hits"), Stats.Hits, int64(1));
+	TestEqual(TEXT("Other size misses"), Stats.Misses, int64(4));
+	TestEqual(TEXT("A hit adds nothing resident"), Stats.NumResident, 4);
+	TestEqual(TEXT("Bytes resident"), Stats.BytesResident, int64(3072));
+	TestEqual(TEXT("Peak bytes resident"), Stats.PeakBytesResident, int64(3072));
+	TestEqual(TEXT("Nothing pooled while in use"), Stats.NumPooled, 0);
+
+	B.Reset();
+	C.Reset();
+	D.Reset();
+	E.Reset();
+
+	Stats = Pool->GetStats();
+	TestEqual(TEXT("Everything released is pooled under the high-water mark"), Stats.NumPooled, 4);
+	TestEqual(TEXT("Pooled readbacks stay resident"), Stats.BytesResident, int64(3072));
+	TestEqual(TEXT("No discards under the high-water mark"), Stats.Discards, int64(0));
+
+	// Lowering the high-water mark trims pooled readbacks down to it
+	const int32 Owner = 0;
+	Pool->SetHighWaterMark(&Owner, 1500);
+	Stats = Pool->GetStats();
+	TestEqual(TEXT("Trimmed until under the high-water mark"), Stats.BytesResident, int64(1024));
+	TestEqual(TEXT("Only pooled readbacks are resident"), Stats.NumResident, Stats.NumPooled);
+
+	Pool->Trim();
+	Stats = Pool->GetStats();
+	TestEqual(TEXT("Trim empties the pool"), Stats.NumPooled, 0);
+	TestEqual(TEXT("Trim releases every pooled readback"), Stats.NumResident, 0);
+	TestEqual(TEXT("Nothing resident after the trim"), Stats.BytesResident, int64(0));
+	TestEqual(TEXT("The peak stays"), Stats.PeakBytesResident, int64(3072));
+
+	TestEqual(TEXT("Bucket of an exact power of two"), FPlanetReadbackPool::GetBucketSize(4096), 4096u);
+	TestEqual(TEXT("Bucket rounds up"), FPlanetReadbackPool::GetBucketSize(4097), 8192u);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlanetReadbackPoolHighWaterMarkTest, "PPG.ComputeShader.ReadbackPool.HighWaterMark",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FPlanetReadbackPoolHighWaterMarkTest::RunTest(const FString& Parameters)
+{
+	const TSharedRef<FPlanetReadbackPool> Pool = MakeShared<FPlanetReadbackPool>();
+
+	const int32 OwnerA = 1;
+	const int32 OwnerB = 2;
+	Pool->SetHighWaterMark(&OwnerA, 1500);
+
+	// Released while over the high-water mark: destroyed, until the rest fits under it
+	TSharedPtr<FRHIGPUBufferReadback> First = Pool->Acquire(1000, TEXT("First"));
+	TSharedPtr<FRHIGPUBufferReadback> Second = Pool->Acquire(1000, TEXT("Second"));
+	First.Reset();
+
+	FPlanetReadbackPool::FStats Stats = Pool->GetStats();
+	TestEqual(TEXT("Released over the high-water mark is discarded"), Stats.Discards, int64(1));
+	TestEqual(TEXT("Discarded readback is not pooled"), Stats.NumPooled, 0);
+	TestEqual(TEXT("Discarded readback is no longer resident"), Stats.NumResident, 1);
+	TestEqual(TEXT("Discarded bytes are no longer resident"), Stats.BytesResident, int64(1024));
+
+	Second.Reset();
+	Stats = Pool->GetStats();
+	TestEqual(TEXT("Released under the high-water mark is pooled"), Stats.NumPooled, 1);
+	TestEqual(TEXT("Still one discard"), Stats.Discards, int64(1));
+
+	// The largest high-water mark of all owners applies
+	Pool->SetHighWaterMark(&OwnerB, 0);
+	TestEqual(TEXT("A smaller high-water mark of another owner does not apply"), Pool->GetHighWaterMark(), int64(1500));
+	TestEqual(TEXT("Nothing is trimmed for it"), Pool->GetStats().NumPooled, 1);
+
+	Pool->ClearHighWaterMark(&OwnerA);
+	TestEqual(TEXT("The remaining owner's high-water mark applies"), Pool->GetHighWaterMark(), int64(0));
+	TestEqual(TEXT("Pooled readbacks over it are trimmed"), Pool->GetStats().NumPooled, 0);
+
+	TSharedPtr<FRHIGPUBufferReadback> Third = Pool->Acquire(1000, TEXT("Third"));
+	Third.Reset();
+	Stats = Pool->GetStats();
+	TestEqual(TEXT("0 disables pooling"), Stats.NumPooled, 0);
+	TestEqual(TEXT("0 discards every release"), Stats.Discards, int64(2));
+	TestEqual(TEXT("Nothing resident"), Stats.BytesResident, int64(0));
+
+	Pool->ClearHighWaterMark(&OwnerB);
+	TestEqual(TEXT("The default applies once no owner is left"), Pool->GetHighWaterMark(), int64(64) * 1024 * 1024);
+
+	return true;
+}
+
+#endif
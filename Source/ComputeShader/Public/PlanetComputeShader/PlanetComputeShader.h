@@ -13,6 +13,21 @@
 #include "RHIGPUReadback.h"
 #include "SceneInterface.h"
 
+//------------------------------------------------------------------------------
+// Readback Format
+// Layout of the vertex data read back to the CPU. The compact formats only carry the radial height,
+// the CPU rebuilds positions from the chunk grid (see FPlanetComputeShaderReadbackFormat).
+//------------------------------------------------------------------------------
+enum class EPlanetReadbackFormat : uint8
+{
+	// Float3 position in Output plus RGBA8 in OutputVC, 16 bytes per vertex
+	Float,
+	// Interleaved uint16s in OutputCompact: height, RG, B + biome index. 6 bytes per vertex.
+	Compact16,
+	// Interleaved uint32s in OutputCompact: height (24 bits) + biome index, RGB. 8 bytes per vertex.
+	Compact24
+};
+
 //------------------------------------------------------------------------------
 // Dispatch Parameters
 // Contains all data needed to execute the planet compute shader.
@@ -48,18 +63,133 @@ struct COMPUTESHADER_API FPlanetComputeShaderDispatchParams
 	// Shader configuration
 	uint32 BiomeCount = 0;          // Number of biomes
 	int32 ChunkQuality = 0;         // Vertices per edge - 1
+	EPlanetReadbackFormat ReadbackFormat = EPlanetReadbackFormat::Float;
+};
+
+//------------------------------------------------------------------------------
+// Batch Layout
+// Per-chunk part of a batched dispatch and where each chunk lives in the shared outputs.
+//------------------------------------------------------------------------------
+
+// Mirrors FPlanetChunkDesc in GenerationUtilities.usf, 16-byte rows
+struct FPlanetComputeShaderChunkDesc
+{
+	FVector3f ChunkLocation = FVector3f::ZeroVector;
+	int32 ChunkQuality = 0;
+	FIntVector ChunkRotation = FIntVector::ZeroValue;
+	uint32 VertexOffset = 0;        // First vertex of the chunk in the output buffers
+	FVector3f ChunkOriginLocation = FVector3f::ZeroVector;
+	float ChunkSize = 0.0f;
+	uint32 BiomeMapRow = 0;         // First row of the chunk in the biome map atlas
+	uint32 Padding[3] = {};
+};
+static_assert(sizeof(FPlanetComputeShaderChunkDesc) == 64, "Must match FPlanetChunkDesc in GenerationUtilities.usf");
+
+// CPU side of a batched dispatch, no RHI involved
+struct COMPUTESHADER_API FPlanetComputeShaderBatchLayout
+{
+	// Biome map atlas rows the batch may use, the chunks' biome maps are stacked in it
+	static constexpr int32 MaxAtlasHeight = 16384;
+
+	TArray<FPlanetComputeShaderChunkDesc> Chunks;
+
+	// Largest chunk grid of the batch, the dispatch covers MaxVertices x MaxVertices x Chunks.Num()
+	int32 MaxVertices = 0;
+	// Size of the shared output buffers, in vertices
+	int32 TotalVertices = 0;
+	FIntPoint BiomeMapAtlasSize = FIntPoint::ZeroValue;
+
+	// Pack the descriptors of Params in dispatch order
+	static FPlanetComputeShaderBatchLayout Build(TConstArrayView<FPlanetComputeShaderDispatchParams> Params);
+
+	// Descriptor of a single chunk, without its place in a batch
+	static FPlanetComputeShaderChunkDesc MakeChunkDesc(const FPlanetComputeShaderDispatchParams& Params);
+
+	// Whether two dispatches can share a batch: same material, scene, planet, input textures and readback format
+	static bool CanBatch(const FPlanetComputeShaderDispatchParams& A, const FPlanetComputeShaderDispatchParams& B);
+
+	// Chunks of VerticesPerEdge that fit into one batch, at most MaxChunks
+	static int32 GetMaxBatchSize(int32 VerticesPerEdge, int32 MaxChunks);
+};
+
+// CPU side of the compact readback formats, no RHI involved
+struct COMPUTESHADER_API FPlanetComputeShaderReadbackFormat
+{
+	static int32 GetBytesPerVertex(EPlanetReadbackFormat Format);
+
+	// Height codes span elevations -1 to 1, 0 to this
+	static uint32 GetMaxHeightCode(EPlanetReadbackFormat Format);
+	static uint32 QuantizeElevation(EPlanetReadbackFormat Format, float Elevation);
+	static float DequantizeElevation(EPlanetReadbackFormat Format, uint32 HeightCode);
+
+	// Unit sphere direction of a chunk grid vertex, as GetVertexPosition in GenerationUtilities.usf
+	static FVector GetVertexDirection(const FPlanetComputeShaderChunkDesc& Chunk, float PlanetRadius, int32 X, int32 Y);
+
+	/**
+	 * Expands one chunk's compact data to the Float layout.
+	 * @param Data - The chunk's vertices, GetBytesPerVertex each
+	 * @param OutPositions - 3 floats per vertex, relative to the chunk origin
+	 * @param OutColors - 4 bytes (RGB + biome index) per vertex
+	 */
+	static void Decode(
+		EPlanetReadbackFormat Format,
+		const uint8* Data,
+		const FPlanetComputeShaderChunkDesc& Chunk,
+		float PlanetRadius,
+		float NoiseHeight,
+		TArray<float>& OutPositions,
+		TArray<uint8>& OutColors
+	);
 };
 
 //------------------------------------------------------------------------------
 // Readback Data
 // Contains GPU buffer readbacks for vertex data retrieval.
+// The buffers of a batched dispatch are shared by all of its chunks, each one reads its own slice.
 //------------------------------------------------------------------------------
+
+// Mapping state of a batch's readback buffers, shared by its chunks
+class FPlanetComputeShaderReadbackMapping;
+
+// One chunk's slice of the mapped readback buffers, read in place from any thread.
+// The batch's buffers stay mapped while any of its chunks holds one of these.
+struct COMPUTESHADER_API FPlanetComputeShaderMappedReadback
+{
+	~FPlanetComputeShaderMappedReadback();
+
+	EPlanetReadbackFormat Format = EPlanetReadbackFormat::Float;
+	int32 NumVertices = 0;
+	// Float: 3 floats per vertex. Compact formats: the interleaved vertices.
+	const uint8* Data = nullptr;
+	// Float only, 4 bytes (RGBA) per vertex
+	const uint8* ColorData = nullptr;
+
+	TSharedPtr<FPlanetComputeShaderReadbackMapping> Mapping;
+};
+
 struct COMPUTESHADER_API FPlanetComputeShaderReadback
 {
-	TSharedPtr<FRHIGPUBufferReadback> OutputBuffer;    // Vertex positions (NumVertices * 3 floats)
-	TSharedPtr<FRHIGPUBufferReadback> OutputVCBuffer;  // Vertex colors (NumVertices * 4 bytes RGBA)
-	int32 NumVertices = 0;                             // Total vertex count
+	TSharedPtr<FRHIGPUBufferReadback> OutputBuffer;    // Vertex positions (3 floats per vertex), or the interleaved compact data
+	TSharedPtr<FRHIGPUBufferReadback> OutputVCBuffer;  // Vertex colors (4 bytes RGBA per vertex), Float format only
+	int32 NumVertices = 0;                             // Vertex count of this chunk
+	int32 VertexOffset = 0;                            // First vertex of this chunk in the buffers
+	EPlanetReadbackFormat Format = EPlanetReadbackFormat::Float;
 	bool bRetryDispatch = false;                       // Material shader is not ready yet; keep the chunk pending.
+	TSharedPtr<FPlanetComputeShaderReadbackMapping> Mapping; // Shared by the chunks of a batch
+
+	bool HasBuffers() const
+	{
+		return OutputBuffer.IsValid() && (Format != EPlanetReadbackFormat::Float || OutputVCBuffer.IsValid());
+	}
+
+	bool IsReady() const
+	{
+		return HasBuffers() && OutputBuffer->IsReady() && (!OutputVCBuffer.IsValid() || OutputVCBuffer->IsReady());
+	}
+
+	// Render thread, once IsReady. Only the first chunk of a batch maps the buffers, nothing is copied.
+	// Returns null if the buffers could not be mapped.
+	TSharedPtr<FPlanetComputeShaderMappedReadback> Map() const;
 };
 
 //------------------------------------------------------------------------------
@@ -80,6 +210,18 @@ public:
 		FPlanetComputeShaderDispatchParams Params
 	);
 
+	/**
+	 * Executes one dispatch for several chunks on the render thread.
+	 * The chunks share the material evaluation setup, the output buffers and one readback per buffer.
+	 * @param RHICmdList - The RHI command list to execute on
+	 * @param Params - Dispatch parameters of each chunk, all compatible according to FPlanetComputeShaderBatchLayout::CanBatch
+	 * @return Readback of each chunk, in the order of Params
+	 */
+	static TArray<FPlanetComputeShaderReadback> DispatchBatchRenderThread(
+		FRHICommandListImmediate& RHICmdList,
+		TConstArrayView<FPlanetComputeShaderDispatchParams> Params
+	);
+
 	/**
 	 * Dispatches the compute shader from any thread.
 	 * If called from render thread, executes immediately.
@@ -114,4 +256,33 @@ public:
 			);
 		}
 	}
+
+	/**
+	 * Dispatches several chunks as one batch from any thread, see DispatchBatchRenderThread.
+	 * @param Params - Dispatch parameters of each chunk
+	 * @param OnDispatchComplete - Callback with the readback of each chunk, on the game thread unless called from the render thread
+	 */
+	static void DispatchBatch(
+		TArray<FPlanetComputeShaderDispatchParams> Params,
+		TFunction<void(TArray<FPlanetComputeShaderReadback> Readbacks)> OnDispatchComplete
+	)
+	{
+		if (IsInRenderingThread())
+		{
+			OnDispatchComplete(DispatchBatchRenderThread(GetImmediateCommandList_ForRenderCommand(), Params));
+		}
+		else
+		{
+			ENQUEUE_RENDER_COMMAND(PlanetComputeShaderDispatchBatch)(
+				[Params = MoveTemp(Params), OnDispatchComplete](FRHICommandListImmediate& RHICmdList)
+				{
+					TArray<FPlanetComputeShaderReadback> Readbacks = DispatchBatchRenderThread(RHICmdList, Params);
+					AsyncTask(ENamedThreads::GameThread, [Readbacks = MoveTemp(Readbacks), OnDispatchComplete]()
+					{
+						OnDispatchComplete(Readbacks);
+					});
+				}
+			);
+		}
+	}
 };
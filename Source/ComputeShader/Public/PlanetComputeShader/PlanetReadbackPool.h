@@ -0,0 +1,73 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2026 Maciej Tkaczewski
+//
+// Planet Readback Pool
+// Recycles the GPU readback objects of the planet compute shader, with their staging buffers.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RHIGPUReadback.h"
+
+//------------------------------------------------------------------------------
+// Readback Pool
+// Readbacks are keyed by their size in bytes rounded up to a power of two, so batches of different sizes share a bucket
+// instead of each one keeping its own readbacks. The staging buffer of a readback follows the size of each copy.
+// A readback handed out by Acquire goes back to its bucket once the last reference to it is gone, unless the
+// pooled readbacks already exceed the high-water mark, then it is destroyed.
+// The bookkeeping never touches the GPU: staging buffers are only created by the first copy into a new readback.
+//------------------------------------------------------------------------------
+class COMPUTESHADER_API FPlanetReadbackPool : public TSharedFromThis<FPlanetReadbackPool>
+{
+public:
+	struct FStats
+	{
+		// Acquires served from the pool, and the ones that had to create a readback
+		int64 Hits = 0;
+		int64 Misses = 0;
+		// Readbacks destroyed on release because the pool was over its high-water mark
+		int64 Discards = 0;
+
+		// Readbacks in use and pooled, and the bytes they were sized for
+		int32 NumResident = 0;
+		int32 NumPooled = 0;
+		int64 BytesResident = 0;
+		int64 PeakBytesResident = 0;
+	};
+
+	~FPlanetReadbackPool();
+
+	// Shared by every planet
+	static FPlanetReadbackPool& Get();
+
+	// Bytes resident (in use and pooled) above which released readbacks are destroyed instead of pooled, 0 disables pooling.
+	// Every Owner (a planet) sets its own and the largest one applies, so one planet cannot shrink the pool under another.
+	void SetHighWaterMark(const void* Owner, int64 InHighWaterMarkBytes);
+	// Drop Owner's high-water mark, the default applies again once no owner is left
+	void ClearHighWaterMark(const void* Owner);
+	int64 GetHighWaterMark() const;
+
+	// Any thread. The readback is accounted for at its bucket size.
+	TSharedPtr<FRHIGPUBufferReadback> Acquire(uint32 NumBytes, const TCHAR* DebugName);
+	static uint32 GetBucketSize(uint32 NumBytes);
+
+	FStats GetStats() const;
+
+	// Destroy every pooled readback
+	void Trim();
+
+private:
+	void Release(FRHIGPUBufferReadback* Readback, uint32 NumBytes);
+	// Expects CriticalSection to be locked, same as TrimTo
+	void ApplyHighWaterMark(TArray<FRHIGPUBufferReadback*>& OutDestroyed);
+	// Expects CriticalSection to be locked, returns the readbacks to destroy outside of it
+	void TrimTo(int64 MaxBytes, TArray<FRHIGPUBufferReadback*>& OutDestroyed);
+	static void Destroy(TArray<FRHIGPUBufferReadback*>& Readbacks);
+
+	mutable FCriticalSection CriticalSection;
+	TMap<uint32, TArray<FRHIGPUBufferReadback*>> Buckets;
+	static constexpr int64 DefaultHighWaterMarkBytes = 64 * 1024 * 1024;
+	TMap<const void*, int64> OwnerHighWaterMarks;
+	int64 HighWaterMarkBytes = DefaultHighWaterMarkBytes;
+	FStats Stats;
+};
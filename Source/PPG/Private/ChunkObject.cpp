@@ -2,6 +2,7 @@
 // Copyright (C) 2026 Maciej Tkaczewski
 
 #include "ChunkObject.h"
+#include "PlanetSpawner.h"
 #include "Engine/GameEngine.h"
 #include "Math/Vector.h"
 #include "Async/Async.h"
@@ -10,6 +11,7 @@
 #include "Kismet/KismetMathLibrary.h"
 #include "PlanetNaniteBuilder.h"
 #include "VoxelMinimal.h"
+#include "VoxelWelfordVariance.h"
 #include "Async/TaskGraphInterfaces.h"
 #include "PhysicsEngine/BodySetup.h"
 #include "VoxelChaosTriangleMeshCooker.h"
@@ -21,27 +23,50 @@
 #include "ComputeShader/Public/PlanetComputeShader/PlanetComputeShader.h"
 
 
+void FChunkFinalizeBudget::BeginFrame(float BudgetMs)
+{
+	if (Frame != GFrameCounter)
+	{
+		Frame = GFrameCounter;
+		BudgetSeconds = 0.0;
+		SpentSeconds = 0.0;
+	}
+	BudgetSeconds = FMath::Max(BudgetSeconds, BudgetMs / 1000.0);
+}
+
+
 UChunkObject::UChunkObject()
 {
 	
 }
 
+void UChunkObject::SetChunkStatus(EChunkStatus NewStatus)
+{
+	check(IsInGameThread());
+
+	const EChunkStatus OldStatus = ChunkStatus;
+	ChunkStatus = NewStatus;
 
+	if (OwningTree != nullptr && OldStatus != NewStatus)
+	{
+		OwningTree->OnChunkStatusChanged(TreeNodeIndex, OldStatus, NewStatus);
+	}
+}
 
 void UChunkObject::GenerationComplete()
 {
 	if (IsInGameThread())
 	{
-		if (bAbortAsync == false)
+		if (!GetAbortAsync())
 		{
 			// Rate-limit component assignment
-			ChunkStatus = EChunkStatus::PENDING_ASSIGN;
+			SetChunkStatus(EChunkStatus::PENDING_ASSIGN);
 		}
 		else
 		{
 			// Cleanup aborted data - including any objects created during generation
 			FreeComponents();
-			ChunkStatus = EChunkStatus::ABORTED;
+			SetChunkStatus(EChunkStatus::ABORTED);
 		}
 
 	}
@@ -56,16 +81,16 @@ void UChunkObject::GenerationComplete()
 			return;
 		}
 
-		if (StrongThis->bAbortAsync == false)
+		if (!StrongThis->GetAbortAsync())
 		{
 			// Rate-limit component assignment
-			StrongThis->ChunkStatus = EChunkStatus::PENDING_ASSIGN;
+			StrongThis->SetChunkStatus(EChunkStatus::PENDING_ASSIGN);
 		}
 		else
 		{
 			// Cleanup aborted data - including any objects created during generation
 			StrongThis->FreeComponents();
-			StrongThis->ChunkStatus = EChunkStatus::ABORTED;
+			StrongThis->SetChunkStatus(EChunkStatus::ABORTED);
 		}
 	});
 	}
@@ -77,22 +102,34 @@ void UChunkObject::SetFoliageActor(AActor* NewFoliageActor)
 	FoliageActor = NewFoliageActor;
 }
 
-void UChunkObject::UploadFoliageData()
+bool UChunkObject::SpawnFoliageComponent(FFoliageRuntimeData& Data, int32 MaxInstances)
 {
-	for (int32 i = 0; i < FoliageRuntimeData.Num(); i++)
+	if (!FoliageActor)
 	{
-		if (bGenerateFoliage == true && FoliageRuntimeData[i].LocalFoliageTransforms.Num() > 0)
-		{
-			SpawnFoliageComponent(FoliageRuntimeData[i]);
-		}
+		return true;
 	}
-}
 
-void UChunkObject::SpawnFoliageComponent(FFoliageRuntimeData& Data)
-{
-	if (!FoliageActor)
+	// Component is already set up, keep adding instances
+	if (Data.Ismc != nullptr)
 	{
-		return;
+		const int32 NumAdded = Data.Ismc->GetInstanceCount();
+		const int32 NumToAdd = FMath::Min(Data.LocalFoliageTransforms.Num() - NumAdded, MaxInstances);
+		if (NumToAdd == Data.LocalFoliageTransforms.Num())
+		{
+			Data.Ismc->AddInstances(Data.LocalFoliageTransforms, false, false, false);
+		}
+		else
+		{
+			Data.Ismc->AddInstances(TArray<FTransform>(Data.LocalFoliageTransforms.GetData() + NumAdded, NumToAdd), false, false, false);
+		}
+
+		if (NumAdded + NumToAdd < Data.LocalFoliageTransforms.Num())
+		{
+			return false;
+		}
+
+		Data.Ismc->RegisterComponent();
+		return true;
 	}
 
 	UInstancedStaticMeshComponent* Ismc = NewObject<UInstancedStaticMeshComponent>(FoliageActor, NAME_None, RF_Transient);
@@ -160,15 +197,27 @@ void UChunkObject::SpawnFoliageComponent(FFoliageRuntimeData& Data)
 	}
 
 	Ismc->SetRelativeTransform(FTransform(ChunkSMC->GetRelativeRotation(), ChunkOriginLocation, FVector(1.0f, 1.0f, 1.0f)));
-	Ismc->AddInstances(Data.LocalFoliageTransforms, false, false, false);
-	Ismc->RegisterComponent();
 	Data.Ismc = Ismc;
+
+	// Instances are added (and the component registered) by the same path as the later slices
+	return SpawnFoliageComponent(Data, MaxInstances);
 }
 
 
 void UChunkObject::GenerateChunk()
 {
-	ChunkStatus = EChunkStatus::GENERATING;
+	FPlanetComputeShaderDispatchParams Params;
+	PrepareDispatch(Params);
+
+	FPlanetComputeShaderInterface::Dispatch(Params, [this](FPlanetComputeShaderReadback Readback)
+	{
+		OnDispatchComplete(Readback);
+	});
+}
+
+void UChunkObject::PrepareDispatch(FPlanetComputeShaderDispatchParams& Params)
+{
+	SetChunkStatus(EChunkStatus::GENERATING);
 
 	// Initialize chunk metrics
 	VerticesCount = ChunkQuality + 1;
@@ -205,7 +254,7 @@ void UChunkObject::GenerateChunk()
 	//--------------------------------------------------------------------------
 	// Setup Compute Shader Parameters
 	//--------------------------------------------------------------------------
-	FPlanetComputeShaderDispatchParams Params(VerticesCount, VerticesCount, 1);
+	Params = FPlanetComputeShaderDispatchParams(VerticesCount, VerticesCount, 1);
 	Params.ChunkLocation = FVector3f(PlanetSpaceLocation);
 	Params.ChunkRotation = PlanetSpaceRotation;
 	Params.ChunkOriginLocation = FVector3f(ChunkOriginLocation);
@@ -217,6 +266,7 @@ void UChunkObject::GenerateChunk()
 	Params.BiomeDataTexture = PlanetData->GPUBiomeData;
 	Params.BiomeCount = PlanetData->BiomeData.Num();
 	Params.ChunkQuality = ChunkQuality;
+	Params.ReadbackFormat = ReadbackFormat;
 	Params.X = VerticesCount;
 	Params.Y = VerticesCount;
 	Params.Z = 1;
@@ -242,6 +292,7 @@ void UChunkObject::GenerateChunk()
 	}
 
 	Params.Random = FMath::Rand();
+	DispatchChunkDesc = FPlanetComputeShaderBatchLayout::MakeChunkDesc(Params);
 
 	// Pre-allocate vertex buffers
 	const int32 TotalVertices = VerticesCount * VerticesCount;
@@ -251,114 +302,79 @@ void UChunkObject::GenerateChunk()
 	VertexHeight.Reserve(VerticesCount * VerticesCount);
 	Slopes.Reserve(VerticesCount * VerticesCount);
 	ForestStrength.Reserve(VerticesCount * VerticesCount);
-	
-	FPlanetComputeShaderReadback Readback;
-	FPlanetComputeShaderInterface::Dispatch(Params, [this](FPlanetComputeShaderReadback Readback)
-	{
-		if (Readback.bRetryDispatch && !bAbortAsync)
-		{
-			ChunkStatus = EChunkStatus::PENDING_GENERATION;
-			return;
-		}
-
-		// Validate the readback has valid data before proceeding
-		if (Readback.NumVertices > 0 && Readback.OutputBuffer.IsValid() && Readback.OutputVCBuffer.IsValid())
-		{
-			GPUReadback = Readback;
-			ChunkStatus = EChunkStatus::WAITING_FOR_GPU;
-		}
-		else
-		{
-			// GPU dispatch failed or returned empty data - abort this chunk
-			UE_LOG(LogTemp, Warning, TEXT("Chunk GPU dispatch returned invalid readback (NumVertices: %d, OutputBuffer: %s, OutputVCBuffer: %s). Aborting chunk."),
-				Readback.NumVertices,
-				Readback.OutputBuffer.IsValid() ? TEXT("Valid") : TEXT("Invalid"),
-				Readback.OutputVCBuffer.IsValid() ? TEXT("Valid") : TEXT("Invalid"));
-			bAbortAsync = true;
-			GenerationComplete();
-		}
-	});
 }
 
-void UChunkObject::TickGPUReadback()
+void UChunkObject::OnDispatchComplete(const FPlanetComputeShaderReadback& Readback)
 {
-	if (ChunkStatus != EChunkStatus::WAITING_FOR_GPU && bAbortAsync == false)
+	if (Readback.bRetryDispatch && !GetAbortAsync())
 	{
+		SetChunkStatus(EChunkStatus::PENDING_GENERATION);
 		return;
 	}
 
-	if (bAbortAsync)
+	// Validate the readback has valid data before proceeding
+	if (Readback.NumVertices > 0 && Readback.HasBuffers())
+	{
+		GPUReadback = Readback;
+		SetChunkStatus(EChunkStatus::WAITING_FOR_GPU);
+	}
+	else
 	{
-		// Clear our reference to the readback buffers
-		GPUReadback.OutputBuffer.Reset();
-		GPUReadback.OutputVCBuffer.Reset();
+		// GPU dispatch failed or returned empty data - abort this chunk
+		UE_LOG(LogTemp, Warning, TEXT("Chunk GPU dispatch returned invalid readback (NumVertices: %d, OutputBuffer: %s, OutputVCBuffer: %s). Aborting chunk."),
+			Readback.NumVertices,
+			Readback.OutputBuffer.IsValid() ? TEXT("Valid") : TEXT("Invalid"),
+			Readback.OutputVCBuffer.IsValid() ? TEXT("Valid") : TEXT("Invalid"));
+		SetAbortAsync();
 		GenerationComplete();
-		return;
 	}
+}
 
-	if (GPUReadback.OutputBuffer.IsValid() && GPUReadback.OutputVCBuffer.IsValid() &&
-		GPUReadback.OutputBuffer->IsReady() && GPUReadback.OutputVCBuffer->IsReady())
-	{
-		// Buffers are ready, dispatch read and process
-		ChunkStatus = EChunkStatus::GENERATING;
+bool UChunkObject::IsReadbackReady() const
+{
+	return GPUReadback.IsReady();
+}
 
-		ENQUEUE_RENDER_COMMAND(ReadChunkData)(
-			[this, Readback = GPUReadback](FRHICommandListImmediate& RHICmdList)
-			{
-				const int32 NumVertices = Readback.NumVertices;
-				
-				// Safety check: abort if no data to read
-				if (NumVertices <= 0)
-				{
-					TWeakObjectPtr<UChunkObject> WeakThis(this);
-					AsyncTask(ENamedThreads::GameThread, [WeakThis]()
-					{
-						if (UChunkObject* StrongThis = WeakThis.Get())
-						{
-							StrongThis->bAbortAsync = true;
-							StrongThis->GenerationComplete();
-						}
-					});
-					return;
-				}
-				
-				// Read position buffer (3 floats per vertex: x, y, z)
-				const int32 NumPositionFloats = NumVertices * 3;
-				float* Buffer = (float*)Readback.OutputBuffer->Lock(NumPositionFloats * sizeof(float));
-				TArray<float> OutVal;
-				OutVal.SetNumUninitialized(NumPositionFloats);
-				FMemory::Memcpy(OutVal.GetData(), Buffer, NumPositionFloats * sizeof(float));
-				Readback.OutputBuffer->Unlock();
-
-				// Read vertex color buffer (4 bytes per vertex: RGBA)
-				const int32 NumColorBytes = NumVertices * 4;
-				uint8* BufferVC = (uint8*)Readback.OutputVCBuffer->Lock(NumColorBytes * sizeof(uint8));
-				TArray<uint8> OutValVC;
-				OutValVC.SetNumUninitialized(NumColorBytes);
-				FMemory::Memcpy(OutValVC.GetData(), BufferVC, NumColorBytes * sizeof(uint8));
-				Readback.OutputVCBuffer->Unlock();
-
-				TWeakObjectPtr<UChunkObject> WeakThis(this);
-				AsyncTask(ENamedThreads::AnyBackgroundHiPriTask, [WeakThis, OutVal = MoveTemp(OutVal), OutValVC = MoveTemp(OutValVC)]()
-				{
-					UChunkObject* StrongThis = WeakThis.Get();
-					if (!StrongThis)
-					{
-						return;
-					}
+void UChunkObject::ReleaseReadback()
+{
+	GPUReadback.OutputBuffer.Reset();
+	GPUReadback.OutputVCBuffer.Reset();
+	GPUReadback.Mapping.Reset();
+}
 
-					if (StrongThis->GetAbortAsync())
-					{
-						StrongThis->GenerationComplete();
-						return;
-					}
-					StrongThis->ProcessChunkData(OutVal, OutValVC);
-				});
-			});
+void UChunkObject::StartReadback(TFunction<void(bool bSuccess)> OnComplete)
+{
+	SetChunkStatus(EChunkStatus::GENERATING);
+
+	ENQUEUE_RENDER_COMMAND(ReadChunkData)(
+		[this, Readback = GPUReadback, OnComplete = MoveTemp(OnComplete)](FRHICommandListImmediate& RHICmdList)
+		{
+			// Safety check: abort if no data to read
+			if (Readback.NumVertices <= 0)
+			{
+				OnComplete(false);
+				return;
+			}
 			
-		// Clear our reference to the readback buffers
-		GPUReadback.OutputBuffer.Reset();
-		GPUReadback.OutputVCBuffer.Reset();
+			// The buffers may be shared with the other chunks of a batched dispatch. The first chunk maps them,
+			// the others only take a reference, and the surface stage reads our slice in place.
+			MappedReadback = Readback.Map();
+			OnComplete(MappedReadback.IsValid());
+		});
+		
+	// Clear our reference to the readback buffers
+	ReleaseReadback();
+}
+
+bool UChunkObject::RunPipelineStage(EChunkPipelineStage Stage)
+{
+	switch (Stage)
+	{
+	case EChunkPipelineStage::Surface: return ProcessSurface();
+	case EChunkPipelineStage::Foliage: return PlaceFoliage();
+	case EChunkPipelineStage::Collision: return CookCollision();
+	case EChunkPipelineStage::RenderData: return BuildRenderData();
+	default: return ensure(false);
 	}
 }
 
@@ -384,19 +400,43 @@ void UChunkObject::InitializeChunk(int InChunkQuality, float InChunkSize, int32
 	FarWaterMesh = InFarWaterMesh;
 }
 
-void UChunkObject::ProcessChunkData(const TArray<float>& OutputVal, const TArray<uint8>& OutputVCVal)
+bool UChunkObject::ProcessSurface()
 {
+	// Unmapped once the stage is done with it
+	const TSharedPtr<FPlanetComputeShaderMappedReadback> Mapped = MoveTemp(MappedReadback);
+	ON_SCOPE_EXIT
+	{
+		ReadbackPositions.Empty();
+		ReadbackColors.Empty();
+	};
+
 	float LocalChunkMaxHeight = 0.0f;
+	TVoxelWelfordVariance<float> HeightVariance;
 
-	if (OutputVal.Num() == 0)
+	if (!Mapped.IsValid() || Mapped->NumVertices != VerticesCount * VerticesCount)
 	{
 		UE_LOG(LogTemp, Error, TEXT("Chunk Process: OutputVal Empty!"));
-		GenerationComplete();
-		return;
+		return false;
+	}
+
+	// The Float layout is read straight from the mapped readback, the compact formats are expanded to it first
+	const float* OutputVal = reinterpret_cast<const float*>(Mapped->Data);
+	const uint8* OutputVCVal = Mapped->ColorData;
+	if (Mapped->Format != EPlanetReadbackFormat::Float)
+	{
+		FPlanetComputeShaderReadbackFormat::Decode(Mapped->Format, Mapped->Data, DispatchChunkDesc,
+			PlanetData->PlanetRadius, PlanetData->NoiseHeight, ReadbackPositions, ReadbackColors);
+		OutputVal = ReadbackPositions.GetData();
+		OutputVCVal = ReadbackColors.GetData();
 	}
 
 	for (int y = 0; y < VerticesCount; y++)
 	{
+		if (GetAbortAsync())
+		{
+			return false;
+		}
+
 		for (int x = 0; x < VerticesCount; x++)
 		{
 			FVector3f Vertex = FVector3f(OutputVal[(x + y * VerticesCount) * 3], OutputVal[(x + y * VerticesCount) * 3 + 1], OutputVal[(x + y * VerticesCount) * 3 + 2]);
@@ -407,6 +447,7 @@ void UChunkObject::ProcessChunkData(const TArray<float>& OutputVal, const TArray
 			float Noise = ((FVector(Vertices[x + y * VerticesCount]) + ChunkOriginLocation).Size() - PlanetData->PlanetRadius) / PlanetData->NoiseHeight;
 
 			float NoiseHeight = Noise * PlanetData->NoiseHeight;
+			HeightVariance.Add(NoiseHeight);
 			if (NoiseHeight > LocalChunkMaxHeight)
 			{
 				LocalChunkMaxHeight = NoiseHeight;
@@ -439,21 +480,29 @@ void UChunkObject::ProcessChunkData(const TArray<float>& OutputVal, const TArray
 		}
 	}
 	ChunkMaxHeight = LocalChunkMaxHeight;
-	
-	CompleteChunkGeneration();
+	HeightDeviation = HeightVariance.GetStd();
 
-
-}
-void UChunkObject::CompleteChunkGeneration()
-{
-	if (bAbortAsync == true)
+	// Second differences of the height along both grid axes, a coarser grid misses up to MaxCurvature * Spacing^2 / 8 of the surface
+	float MaxSecondDifference = 0.0f;
+	for (int y = 1; y < VerticesCount - 1; y++)
 	{
-		GenerationComplete();
-		return;
+		for (int x = 1; x < VerticesCount - 1; x++)
+		{
+			const float Center = 2.0f * VertexHeight[x + y * VerticesCount];
+			const float DifferenceX = VertexHeight[x - 1 + y * VerticesCount] + VertexHeight[x + 1 + y * VerticesCount] - Center;
+			const float DifferenceY = VertexHeight[x + (y - 1) * VerticesCount] + VertexHeight[x + (y + 1) * VerticesCount] - Center;
+			MaxSecondDifference = FMath::Max(MaxSecondDifference, FMath::Max(FMath::Abs(DifferenceX), FMath::Abs(DifferenceY)));
+		}
 	}
+	MaxCurvature = MaxSecondDifference / FMath::Square(TriangleSize);
 
 	for (int y = 0; y < VerticesCount; y++)
 	{
+		if (GetAbortAsync())
+		{
+			return false;
+		}
+
 		if (y == VerticesCount - 1)
 		{
 			for (int x = 0; x < VerticesCount - 1; x++)
@@ -531,12 +580,11 @@ void UChunkObject::CompleteChunkGeneration()
 		}
 	}
 
-	if (bAbortAsync == true)
-	{
-		GenerationComplete();
-		return;
-	}
-	
+	return true;
+}
+
+bool UChunkObject::PlaceFoliage()
+{
 	// Foliage Processing
 	if (bGenerateFoliage && ForestStrength.Num() > 0 && Vertices.Num() > 0)
 	{
@@ -549,10 +597,9 @@ void UChunkObject::CompleteChunkGeneration()
 				{
 					if (!FoliageData) continue;
 					
-					if (bAbortAsync == true)
+					if (GetAbortAsync())
 					{
-						GenerationComplete();
-						return;
+						return false;
 					}
 
 					for (const FFoliageList& Foliage : FoliageData->FoliageList)
@@ -604,6 +651,11 @@ void UChunkObject::CompleteChunkGeneration()
 							
 							for (int y = 0; y < LocalDensity; y++)
 							{
+								if (GetAbortAsync())
+								{
+									return false;
+								}
+
 								for (int z = 0; z < LocalDensity; z++)
 								{
 
@@ -793,16 +845,23 @@ void UChunkObject::CompleteChunkGeneration()
 		}
 	}
 
-
-	UploadChunk();
-
+	return true;
 }
 
+bool UChunkObject::CookCollision()
+{
+	if (bCollisions)
+	{
+		TConstVoxelArrayView<FVector3f> Positions(Vertices.GetData(), Vertices.Num());
+		TConstVoxelArrayView<uint16> FaceMaterials;
+		PendingCollisionData = Chaos::FTriangleMeshImplicitObjectPtr(FVoxelChaosTriangleMeshCooker::Create(TArray<int32>(*Triangles), Positions, FaceMaterials, &CancellationToken->GetFlag()));
+	}
 
+	return !GetAbortAsync();
+}
 
-void UChunkObject::UploadChunk()
+bool UChunkObject::BuildRenderData()
 {
-
 	//convert vertices to Positions
 	TConstVoxelArrayView<FVector3f> Positions(Vertices.GetData(), Vertices.Num());
 
@@ -825,225 +884,240 @@ void UChunkObject::UploadChunk()
 	NaniteBuilder.Mesh.TextureCoordinates = TextureCoordinatesVV;
 
 
-	Chaos::FTriangleMeshImplicitObjectPtr ChaosMeshData;
-	if (bCollisions)
-	{
-		TConstVoxelArrayView<uint16> FaceMaterials;
-		ChaosMeshData = Chaos::FTriangleMeshImplicitObjectPtr (FVoxelChaosTriangleMeshCooker::Create(TArray<int32>(*Triangles), Positions, FaceMaterials));
-	}
-	
-	if (bAbortAsync == true)
-	{
-		GenerationComplete();
-		return;
-	}
-
 	// Generate the render data
-	TUniquePtr<FStaticMeshRenderData> RenderData = NaniteBuilder.CreateRenderData(bAbortAsync, bRayTracing, bNaniteLandscape);
-	
-	if (bAbortAsync == true)
-	{
-		GenerationComplete();
-		return;
-	}
-	
-	// Use TWeakObjectPtr to safely handle potential GC during async execution
-	TWeakObjectPtr<UChunkObject> WeakThis(this);
-	bool bLocalRayTracing = bRayTracing;
-	bool bLocalCollisions = bCollisions;
-	bool bLocalNaniteLandscape = bNaniteLandscape;
-	
-	AsyncTask(ENamedThreads::GameThread, [WeakThis, ChaosMeshData, bLocalRayTracing, bLocalCollisions, bLocalNaniteLandscape, RenderData = MoveTemp(RenderData)]() mutable
+	PendingRenderData = NaniteBuilder.CreateRenderData(CancellationToken->GetFlag(), bRayTracing, bNaniteLandscape);
+
+	return PendingRenderData.IsValid() && !GetAbortAsync();
+}
+
+void UChunkObject::AssignComponents()
+{
+	while (ChunkStatus == EChunkStatus::PENDING_ASSIGN && FChunkFinalizeBudget::HasTime())
 	{
-		UChunkObject* StrongThis = WeakThis.Get();
-		if (!StrongThis)
-		{
-			// Object was garbage collected, clean up render data
-			RenderData.Reset();
-			return;
-		}
-		
-		if (StrongThis->bAbortAsync == true)
+		const double StartTime = FPlatformTime::Seconds();
+		const bool bProgress = RunFinalizeStep();
+		FChunkFinalizeBudget::Spend(FPlatformTime::Seconds() - StartTime);
+
+		if (!bProgress)
 		{
-			StrongThis->GenerationComplete();
+			// Remain in PENDING_ASSIGN and retry next frame
 			return;
 		}
+	}
+}
 
-		StrongThis->ChunkStaticMesh = NewObject<UStaticMesh>(StrongThis, NAME_None, RF_Transient);
-		StrongThis->ChunkStaticMesh->bDoFastBuild = true;
-		StrongThis->ChunkStaticMesh->bGenerateMeshDistanceField = false;
-		StrongThis->ChunkStaticMesh->SetStaticMaterials({ FStaticMaterial() });
-		StrongThis->ChunkStaticMesh->bSupportRayTracing = bLocalRayTracing;
+bool UChunkObject::RunFinalizeStep()
+{
+	switch (FinalizeStep)
+	{
+	case EFinalizeStep::CreateMesh:
+	{
+		ChunkStaticMesh = NewObject<UStaticMesh>(this, NAME_None, RF_Transient);
+		ChunkStaticMesh->bDoFastBuild = true;
+		ChunkStaticMesh->bGenerateMeshDistanceField = false;
+		ChunkStaticMesh->SetStaticMaterials({ FStaticMaterial() });
+		ChunkStaticMesh->bSupportRayTracing = bRayTracing;
 
 
-		if (bLocalCollisions)
+		if (bCollisions)
 		{
-			StrongThis->ChunkStaticMesh->CreateBodySetup();
+			ChunkStaticMesh->CreateBodySetup();
 
-			UBodySetup* BodySetup = StrongThis->ChunkStaticMesh->GetBodySetup();
+			UBodySetup* BodySetup = ChunkStaticMesh->GetBodySetup();
 			BodySetup->bGenerateMirroredCollision = false;
 			BodySetup->bDoubleSidedGeometry = false;
 			BodySetup->bSupportUVsAndFaceRemap = false;
 			BodySetup->CollisionTraceFlag = CTF_UseComplexAsSimple;
 
-			BodySetup->TriMeshGeometries = { ChaosMeshData };
+			BodySetup->TriMeshGeometries = { PendingCollisionData };
 
 			BodySetup->bHasCookedCollisionData = true;
 			BodySetup->bCreatedPhysicsMeshes = true;
 		}
 
-		StrongThis->ChunkStaticMesh->SetRenderData(MoveTemp(RenderData));
+		ChunkStaticMesh->SetRenderData(MoveTemp(PendingRenderData));
 
 		#if WITH_EDITOR
-		StrongThis->ChunkStaticMesh->NaniteSettings.bEnabled = bLocalNaniteLandscape;
+		ChunkStaticMesh->NaniteSettings.bEnabled = bNaniteLandscape;
 		#endif
 
-		StrongThis->ChunkStaticMesh->CalculateExtendedBounds();
-		StrongThis->ChunkStaticMesh->InitResources();
+		ChunkStaticMesh->CalculateExtendedBounds();
+		ChunkStaticMesh->InitResources();
 
+		PendingCollisionData = nullptr;
 
-		StrongThis->GenerationComplete();
+		FinalizeStep = EFinalizeStep::SetupMaterial;
+		return true;
+	}
+	case EFinalizeStep::SetupMaterial:
+	{
+		// InitResources() is async, the render data has to be ready before a component can use the mesh
+		if (!ChunkStaticMesh || !ChunkStaticMesh->GetRenderData() || !ChunkStaticMesh->GetRenderData()->IsInitialized())
+		{
+			return false;
+		}
 
-	});
-	
+		if ((*ChunkSMCPool).IsEmpty() == false)
+		{
+			//get avaliable ChunkSMC
+			ChunkSMC = (*ChunkSMCPool).Pop();
+			ChunkSMC->SetRelativeLocation(ChunkOriginLocation);
+			ChunkSMC->GetComponentVelocity() = FVector::ZeroVector;
+			ChunkSMC->ResetSceneVelocity();
+			ChunkSMC->SetVisibility(true);
+		}
+		else
+		{
+			ChunkSMC = NewObject<UStaticMeshComponent>(this, UStaticMeshComponent::StaticClass(), NAME_None, RF_Transient);
+			ChunkSMC->SetupAttachment(Cast<AActor>(GetOuter())->GetRootComponent());
+			ChunkSMC->SetMobility(EComponentMobility::Movable);
+			ChunkSMC->SetCanEverAffectNavigation(false);
+			ChunkSMC->ShadowCacheInvalidationBehavior = EShadowCacheInvalidationBehavior::Always;
+			ChunkSMC->bWorldPositionOffsetWritesVelocity = false;
+			ChunkSMC->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+			ChunkSMC->SetRelativeLocation(ChunkOriginLocation);
+			ChunkSMC->GetComponentVelocity() = FVector::ZeroVector;
+			ChunkSMC->ResetSceneVelocity();
+		}
 
-}
+		//--------------------------------------------------------------------------
+		// Setup Dynamic Material Instance
+		//--------------------------------------------------------------------------
+		TObjectPtr<UMaterialInstanceDynamic> MaterialInst = ChunkSMC->CreateDynamicMaterialInstance(0, PlanetData->PlanetMaterial);
+
+		// Global material parameters
+		MaterialInst->SetTextureParameterValue("BiomeMap", BiomeMap);
+		MaterialInst->SetTextureParameterValue("BiomeData", PlanetData->GPUBiomeData);
+		MaterialInst->SetScalarParameterValue("recursionLevel", PlanetData->MaxRecursionLevel - RecursionLevel);
+		MaterialInst->SetScalarParameterValue("PlanetRadius", PlanetData->PlanetRadius);
+		MaterialInst->SetScalarParameterValue("NoiseHeight", PlanetData->NoiseHeight);
+		MaterialInst->SetScalarParameterValue("ChunkSize", ChunkSize);
+		MaterialInst->SetVectorParameterValue("ComponentLocation", ChunkOriginLocation);
+
+		//--------------------------------------------------------------------------
+		// Setup Material Layer Parameters
+		// MaterialLayersNum = total layers in stack (Background + N overlay layers)
+		// Blend parameters: indices 0 to (MaterialLayersNum-2), for layers 1+
+		// Layer parameters: indices 0 to (MaterialLayersNum-1), for all layers
+		//--------------------------------------------------------------------------
+		for (int32 LayerIdx = 0; LayerIdx < MaterialLayersNum; LayerIdx++)
+		{
+			// Blend parameters (only for overlay layers, not background)
+			if (LayerIdx > 0)
+			{
+				const int32 BlendIdx = LayerIdx - 1;
+		
+				FMaterialParameterInfo LayerIndexInfo;
+				LayerIndexInfo.Name = "LayerIndex";
+				LayerIndexInfo.Association = EMaterialParameterAssociation::BlendParameter;
+				LayerIndexInfo.Index = BlendIdx;
+				MaterialInst->SetScalarParameterValueByInfo(LayerIndexInfo, float(LayerIdx) + 0.01f);
+
+				FMaterialParameterInfo BiomeCountInfo;
+				BiomeCountInfo.Name = "BiomeCount";
+				BiomeCountInfo.Association = EMaterialParameterAssociation::BlendParameter;
+				BiomeCountInfo.Index = BlendIdx;
+				MaterialInst->SetScalarParameterValueByInfo(BiomeCountInfo, float(MaterialLayersNum) + 0.01f);
+
+				FMaterialParameterInfo BlendMapInfo;
+				BlendMapInfo.Name = "BiomeMap";
+				BlendMapInfo.Association = EMaterialParameterAssociation::BlendParameter;
+				BlendMapInfo.Index = BlendIdx;
+				MaterialInst->SetTextureParameterValueByInfo(BlendMapInfo, BiomeMap);
+			}
 
-void UChunkObject::AssignComponents()
-{
-	// Early validation: Check if ChunkStaticMesh is ready before doing any work
-	// This can happen if InitResources() hasn't completed yet (it's async)
-	if (!ChunkStaticMesh || !ChunkStaticMesh->GetRenderData() || !ChunkStaticMesh->GetRenderData()->IsInitialized())
-	{
-		// Render data not ready yet, remain in PENDING_ASSIGN to retry next frame
-		return;
-	}
-	
-	if ((*ChunkSMCPool).IsEmpty() == false)
-	{
-		//get avaliable ChunkSMC
-		ChunkSMC = (*ChunkSMCPool).Pop();
-		ChunkSMC->SetRelativeLocation(ChunkOriginLocation);
-		ChunkSMC->GetComponentVelocity() = FVector::ZeroVector;
-		ChunkSMC->ResetSceneVelocity();
-		ChunkSMC->SetVisibility(true);
+			// Per-layer parameters (all layers including background)
+			FMaterialParameterInfo RadiusInfo;
+			RadiusInfo.Name = "PlanetRadius";
+			RadiusInfo.Association = EMaterialParameterAssociation::LayerParameter;
+			RadiusInfo.Index = LayerIdx;
+			MaterialInst->SetScalarParameterValueByInfo(RadiusInfo, PlanetData->PlanetRadius);
+
+			FMaterialParameterInfo HeightInfo;
+			HeightInfo.Name = "NoiseHeight";
+			HeightInfo.Association = EMaterialParameterAssociation::LayerParameter;
+			HeightInfo.Index = LayerIdx;
+			MaterialInst->SetScalarParameterValueByInfo(HeightInfo, PlanetData->NoiseHeight);
+
+			FMaterialParameterInfo SizeInfo;
+			SizeInfo.Name = "ChunkSize";
+			SizeInfo.Association = EMaterialParameterAssociation::LayerParameter;
+			SizeInfo.Index = LayerIdx;
+			MaterialInst->SetScalarParameterValueByInfo(SizeInfo, ChunkSize);
+
+			FMaterialParameterInfo LocationInfo;
+			LocationInfo.Name = "ComponentLocation";
+			LocationInfo.Association = EMaterialParameterAssociation::LayerParameter;
+			LocationInfo.Index = LayerIdx;
+			MaterialInst->SetVectorParameterValueByInfo(LocationInfo, ChunkOriginLocation);
+
+			FMaterialParameterInfo RecursionInfo;
+			RecursionInfo.Name = "recursionLevel";
+			RecursionInfo.Association = EMaterialParameterAssociation::LayerParameter;
+			RecursionInfo.Index = LayerIdx;
+			MaterialInst->SetScalarParameterValueByInfo(RecursionInfo, PlanetData->MaxRecursionLevel - RecursionLevel);
+		}
+		MaterialInst = nullptr;
+
+		FinalizeStep = EFinalizeStep::SpawnFoliage;
+		return true;
 	}
-	else
+	case EFinalizeStep::SpawnFoliage:
 	{
-		ChunkSMC = NewObject<UStaticMeshComponent>(this, UStaticMeshComponent::StaticClass(), NAME_None, RF_Transient);
-		ChunkSMC->SetupAttachment(Cast<AActor>(GetOuter())->GetRootComponent());
-		ChunkSMC->SetMobility(EComponentMobility::Movable);
-		ChunkSMC->SetCanEverAffectNavigation(false);
-		ChunkSMC->ShadowCacheInvalidationBehavior = EShadowCacheInvalidationBehavior::Always;
-		ChunkSMC->bWorldPositionOffsetWritesVelocity = false;
-		ChunkSMC->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-		ChunkSMC->SetRelativeLocation(ChunkOriginLocation);
-		ChunkSMC->GetComponentVelocity() = FVector::ZeroVector;
-		ChunkSMC->ResetSceneVelocity();
+		//--------------------------------------------------------------------------
+		// Upload Foliage Data, sliced so a dense chunk spreads over several frames
+		//--------------------------------------------------------------------------
+		while (bGenerateFoliage && FinalizeFoliageIndex < FoliageRuntimeData.Num())
+		{
+			FFoliageRuntimeData& Data = FoliageRuntimeData[FinalizeFoliageIndex];
+			if (Data.LocalFoliageTransforms.Num() > 0)
+			{
+				if (!SpawnFoliageComponent(Data, FoliageInstancesPerStep))
+				{
+					return true;
+				}
+
+				Data.LocalFoliageTransforms.Empty();
+				Data.LocalFoliageTransforms.Shrink();
+				FinalizeFoliageIndex++;
+				return true;
+			}
+			FinalizeFoliageIndex++;
+		}
+
+		FinalizeStep = EFinalizeStep::AddWater;
+		return true;
 	}
-	
-	//--------------------------------------------------------------------------
-	// Setup Dynamic Material Instance
-	//--------------------------------------------------------------------------
-	TObjectPtr<UMaterialInstanceDynamic> MaterialInst = ChunkSMC->CreateDynamicMaterialInstance(0, PlanetData->PlanetMaterial);
-	
-	// Global material parameters
-	MaterialInst->SetTextureParameterValue("BiomeMap", BiomeMap);
-	MaterialInst->SetTextureParameterValue("BiomeData", PlanetData->GPUBiomeData);
-	MaterialInst->SetScalarParameterValue("recursionLevel", PlanetData->MaxRecursionLevel - RecursionLevel);
-	MaterialInst->SetScalarParameterValue("PlanetRadius", PlanetData->PlanetRadius);
-	MaterialInst->SetScalarParameterValue("NoiseHeight", PlanetData->NoiseHeight);
-	MaterialInst->SetScalarParameterValue("ChunkSize", ChunkSize);
-	MaterialInst->SetVectorParameterValue("ComponentLocation", ChunkOriginLocation);
-	
-	//--------------------------------------------------------------------------
-	// Setup Material Layer Parameters
-	// MaterialLayersNum = total layers in stack (Background + N overlay layers)
-	// Blend parameters: indices 0 to (MaterialLayersNum-2), for layers 1+
-	// Layer parameters: indices 0 to (MaterialLayersNum-1), for all layers
-	//--------------------------------------------------------------------------
-	for (int32 LayerIdx = 0; LayerIdx < MaterialLayersNum; LayerIdx++)
+	case EFinalizeStep::AddWater:
 	{
-		// Blend parameters (only for overlay layers, not background)
-		if (LayerIdx > 0)
+		if (ChunkMinHeight < 0 && PlanetData->bGenerateWater)
 		{
-			const int32 BlendIdx = LayerIdx - 1;
-			
-			FMaterialParameterInfo LayerIndexInfo;
-			LayerIndexInfo.Name = "LayerIndex";
-			LayerIndexInfo.Association = EMaterialParameterAssociation::BlendParameter;
-			LayerIndexInfo.Index = BlendIdx;
-			MaterialInst->SetScalarParameterValueByInfo(LayerIndexInfo, float(LayerIdx) + 0.01f);
-
-			FMaterialParameterInfo BiomeCountInfo;
-			BiomeCountInfo.Name = "BiomeCount";
-			BiomeCountInfo.Association = EMaterialParameterAssociation::BlendParameter;
-			BiomeCountInfo.Index = BlendIdx;
-			MaterialInst->SetScalarParameterValueByInfo(BiomeCountInfo, float(MaterialLayersNum) + 0.01f);
-
-			FMaterialParameterInfo BlendMapInfo;
-			BlendMapInfo.Name = "BiomeMap";
-			BlendMapInfo.Association = EMaterialParameterAssociation::BlendParameter;
-			BlendMapInfo.Index = BlendIdx;
-			MaterialInst->SetTextureParameterValueByInfo(BlendMapInfo, BiomeMap);
+			AddWaterChunk();
 		}
 
-		// Per-layer parameters (all layers including background)
-		FMaterialParameterInfo RadiusInfo;
-		RadiusInfo.Name = "PlanetRadius";
-		RadiusInfo.Association = EMaterialParameterAssociation::LayerParameter;
-		RadiusInfo.Index = LayerIdx;
-		MaterialInst->SetScalarParameterValueByInfo(RadiusInfo, PlanetData->PlanetRadius);
-
-		FMaterialParameterInfo HeightInfo;
-		HeightInfo.Name = "NoiseHeight";
-		HeightInfo.Association = EMaterialParameterAssociation::LayerParameter;
-		HeightInfo.Index = LayerIdx;
-		MaterialInst->SetScalarParameterValueByInfo(HeightInfo, PlanetData->NoiseHeight);
-
-		FMaterialParameterInfo SizeInfo;
-		SizeInfo.Name = "ChunkSize";
-		SizeInfo.Association = EMaterialParameterAssociation::LayerParameter;
-		SizeInfo.Index = LayerIdx;
-		MaterialInst->SetScalarParameterValueByInfo(SizeInfo, ChunkSize);
-
-		FMaterialParameterInfo LocationInfo;
-		LocationInfo.Name = "ComponentLocation";
-		LocationInfo.Association = EMaterialParameterAssociation::LayerParameter;
-		LocationInfo.Index = LayerIdx;
-		MaterialInst->SetVectorParameterValueByInfo(LocationInfo, ChunkOriginLocation);
-
-		FMaterialParameterInfo RecursionInfo;
-		RecursionInfo.Name = "recursionLevel";
-		RecursionInfo.Association = EMaterialParameterAssociation::LayerParameter;
-		RecursionInfo.Index = LayerIdx;
-		MaterialInst->SetScalarParameterValueByInfo(RecursionInfo, PlanetData->MaxRecursionLevel - RecursionLevel);
+		FinalizeStep = EFinalizeStep::Register;
+		return true;
 	}
-	MaterialInst = nullptr;
-	
-	//--------------------------------------------------------------------------
-	// Upload Foliage Data
-	//--------------------------------------------------------------------------
-	if (bGenerateFoliage)
+	case EFinalizeStep::Register:
 	{
-		UploadFoliageData();
-		for (FFoliageRuntimeData& Data : FoliageRuntimeData)
+		ChunkSMC->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+		ChunkSMC->SetCollisionResponseToChannels(CollisionSetup);
+		ChunkSMC->SetStaticMesh(ChunkStaticMesh);
+		ChunkSMC->RegisterComponent();
+
+		// Same frame as our own components, so neither a gap nor both chunks show
+		if (UChunkObject* Replaced = ReplacedChunk.Get())
 		{
-			Data.LocalFoliageTransforms.Empty();
-			Data.LocalFoliageTransforms.Shrink();
+			Replaced->FreeComponents();
 		}
+		ReplacedChunk = nullptr;
+
+		SetChunkStatus(EChunkStatus::READY);
+		return true;
 	}
-	
-	if (ChunkMinHeight < 0 && PlanetData->bGenerateWater)
-	{
-		AddWaterChunk();
 	}
-	
-	ChunkSMC->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
-	ChunkSMC->SetCollisionResponseToChannels(CollisionSetup);
-	ChunkSMC->SetStaticMesh(ChunkStaticMesh);
-	ChunkSMC->RegisterComponent();
-	ChunkStatus = EChunkStatus::READY;
+
+	return false;
 }
 
 
@@ -1201,14 +1275,14 @@ void UChunkObject::FreeComponents()
 
 void UChunkObject::BeginSelfDestruct()
 {
-	ChunkStatus = EChunkStatus::REMOVING;
-	bAbortAsync = true;
+	SetChunkStatus(EChunkStatus::REMOVING);
+	SetAbortAsync();
 }
 
 void UChunkObject::SelfDestruct()
 {
 	FreeComponents();
-	bAbortAsync = true;
+	SetAbortAsync();
 	
 	WaterChunk = nullptr;
 
@@ -1235,10 +1309,14 @@ void UChunkObject::SelfDestruct()
 	Biomes.Shrink();
 	FoliageRuntimeData.Empty();
 	FoliageRuntimeData.Shrink();
+	PendingRenderData.Reset();
+	PendingCollisionData = nullptr;
 	
 	// Clear our reference to the readback buffers
 	GPUReadback.OutputBuffer.Reset();
 	GPUReadback.OutputVCBuffer.Reset();
+	GPUReadback.Mapping.Reset();
+	MappedReadback.Reset();
 
 	ConditionalBeginDestroy();
 }
@@ -0,0 +1,642 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2026 Maciej Tkaczewski
+
+#include "ChunkPipeline.h"
+#include "ChunkObject.h"
+
+const TCHAR* LexToString(EChunkPipelineStage Stage)
+{
+	switch (Stage)
+	{
+	case EChunkPipelineStage::Dispatch: return TEXT("Dispatch");
+	case EChunkPipelineStage::Readback: return TEXT("Readback");
+	case EChunkPipelineStage::Surface: return TEXT("Surface");
+	case EChunkPipelineStage::Foliage: return TEXT("Foliage");
+	case EChunkPipelineStage::Collision: return TEXT("Collision");
+	case EChunkPipelineStage::RenderData: return TEXT("RenderData");
+	case EChunkPipelineStage::Assign: return TEXT("Assign");
+	default: return TEXT("Unknown");
+	}
+}
+
+static EChunkPipelineStage NextStage(EChunkPipelineStage Stage)
+{
+	return static_cast<EChunkPipelineStage>(static_cast<int32>(Stage) + 1);
+}
+
+// Started together once Surface is done, joined before Assign
+static constexpr EChunkPipelineStage BranchStages[] = { EChunkPipelineStage::Foliage, EChunkPipelineStage::Collision, EChunkPipelineStage::RenderData };
+
+bool FChunkPipeline::IsBranchStage(EChunkPipelineStage Stage)
+{
+	return Stage == EChunkPipelineStage::Foliage || Stage == EChunkPipelineStage::Collision || Stage == EChunkPipelineStage::RenderData;
+}
+
+void FChunkPipeline::Configure(EChunkPipelineStage Stage, const FStageSettings& Settings)
+{
+	FScopeLock Lock(&CriticalSection);
+	Stages[static_cast<int32>(Stage)].Settings = Settings;
+}
+
+void FChunkPipeline::SetMaxInFlight(int32 InMaxInFlight)
+{
+	FScopeLock Lock(&CriticalSection);
+	MaxInFlight = InMaxInFlight;
+}
+
+int32 FChunkPipeline::GetDispatchCapacity() const
+{
+	FScopeLock Lock(&CriticalSection);
+
+	const FStage& Dispatch = Stages[static_cast<int32>(EChunkPipelineStage::Dispatch)];
+	const FStage& Readback = Stages[static_cast<int32>(EChunkPipelineStage::Readback)];
+
+	int32 Capacity = MaxInFlight - GetNumInFlightLocked();
+	Capacity = FMath::Min(Capacity, Dispatch.Settings.MaxConcurrency - Dispatch.NumActive);
+	Capacity = FMath::Min(Capacity, Readback.Settings.QueueCapacity - (Readback.Queue.Num() + Dispatch.NumActive));
+	return FMath::Max(Capacity, 0);
+}
+
+void FChunkPipeline::SetMaxBatchSize(int32 InMaxBatchSize)
+{
+	check(IsInGameThread());
+	MaxBatchSize = FMath::Max(InMaxBatchSize, 1);
+}
+
+void FChunkPipeline::SetBatchDispatcher(FBatchDispatcher InBatchDispatcher)
+{
+	check(IsInGameThread());
+	BatchDispatcher = MoveTemp(InBatchDispatcher);
+}
+
+void FChunkPipeline::Dispatch(UChunkObject* Chunk, EChunkTaskLane Lane)
+{
+	check(IsInGameThread());
+
+	FPendingDispatch& Pending = PendingDispatches.AddDefaulted_GetRef();
+	Pending.Chunk = Chunk;
+	Chunk->PrepareDispatch(Pending.Params);
+
+	FScopeLock Lock(&CriticalSection);
+	InFlightChunks.Add(Chunk);
+	Enqueue(EChunkPipelineStage::Dispatch, Chunk, Lane);
+	Stages[static_cast<int32>(EChunkPipelineStage::Dispatch)].NumActive++;
+}
+
+void FChunkPipeline::FlushDispatches()
+{
+	check(IsInGameThread());
+
+	TArray<FPendingDispatch> Pending = MoveTemp(PendingDispatches);
+	PendingDispatches.Reset();
+
+	// Chunks cancelled before their GPU work was submitted skip it
+	for (int32 Index = Pending.Num() - 1; Index >= 0; Index--)
+	{
+		UChunkObject* Chunk = Pending[Index].Chunk;
+		if (Chunk->GetAbortAsync())
+		{
+			Chunk->GenerationComplete();
+
+			FScopeLock Lock(&CriticalSection);
+			LeaveDispatch(Chunk, false);
+			Pending.RemoveAt(Index, 1, EAllowShrinking::No);
+		}
+	}
+
+	while (Pending.Num() > 0)
+	{
+		// Batch everything that shares the first chunk's material, planet and grid size, as far as the batch size allows
+		const FPlanetComputeShaderDispatchParams First = Pending[0].Params;
+		const int32 MaxChunks = FPlanetComputeShaderBatchLayout::GetMaxBatchSize(FMath::Max(First.X, First.Y), MaxBatchSize);
+
+		TArray<TWeakObjectPtr<UChunkObject>> BatchChunks;
+		TArray<FPlanetComputeShaderDispatchParams> BatchParams;
+		for (int32 Index = 0; Index < Pending.Num() && BatchParams.Num() < MaxChunks; Index++)
+		{
+			const FPlanetComputeShaderDispatchParams& Params = Pending[Index].Params;
+			if (Params.X != First.X || Params.Y != First.Y || !FPlanetComputeShaderBatchLayout::CanBatch(First, Params))
+			{
+				continue;
+			}
+
+			BatchChunks.Add(Pending[Index].Chunk);
+			BatchParams.Add(Params);
+			Pending.RemoveAt(Index--, 1, EAllowShrinking::No);
+		}
+
+		BatchDispatcher(MoveTemp(BatchParams),
+			[WeakPipeline = AsWeak(), BatchChunks = MoveTemp(BatchChunks), CurrentEpoch = Epoch](TArray<FPlanetComputeShaderReadback> Readbacks)
+			{
+				if (const TSharedPtr<FChunkPipeline> Pipeline = WeakPipeline.Pin())
+				{
+					Pipeline->OnBatchDispatched(BatchChunks, Readbacks, CurrentEpoch);
+					return;
+				}
+
+				for (int32 Index = 0; Index < BatchChunks.Num(); Index++)
+				{
+					if (UChunkObject* Chunk = BatchChunks[Index].Get())
+					{
+						Chunk->OnDispatchComplete(Readbacks[Index]);
+					}
+				}
+			});
+	}
+}
+
+void FChunkPipeline::Tick()
+{
+	check(IsInGameThread());
+
+	FlushDispatches();
+
+	int32 MaxAssigning = 0;
+	{
+		FScopeLock Lock(&CriticalSection);
+		TickDispatch();
+		TickReadback();
+
+		// Chunks handed over by the render data workers since the last tick
+		FStage& State = Stages[static_cast<int32>(EChunkPipelineStage::Assign)];
+		AssignEntries.Append(State.Queue);
+		State.Queue.Reset();
+		MaxAssigning = State.Settings.MaxConcurrency;
+	}
+
+	// Finalization runs the chunks' game-thread code, so it stays outside of the lock the workers hand their chunks over with
+	TArray<double> FinishedEnqueueTimes;
+	const int32 NumWaiting = TickAssign(MaxAssigning, FinishedEnqueueTimes);
+
+	{
+		FScopeLock Lock(&CriticalSection);
+
+		FStage& State = Stages[static_cast<int32>(EChunkPipelineStage::Assign)];
+		State.NumActive = AssignEntries.Num() - NumWaiting - NumAssignHeld;
+		NumAssignWaiting = NumWaiting;
+		for (const double EnqueueTime : FinishedEnqueueTimes)
+		{
+			RecordExit(EChunkPipelineStage::Assign, EnqueueTime);
+		}
+
+		UpdateStats();
+	}
+	Pump();
+
+	// Runs after this frame's dispatches on the render thread, what it finds ready is moved on by the next Tick
+	ReadbackQueue->EnqueuePoll();
+}
+
+void FChunkPipeline::Reset()
+{
+	check(IsInGameThread());
+
+	// Never submitted, so no dispatch callback will finish them
+	for (const FPendingDispatch& Pending : PendingDispatches)
+	{
+		Pending.Chunk->SetAbortAsync();
+		Pending.Chunk->GenerationComplete();
+	}
+	PendingDispatches.Empty();
+
+	{
+		FScopeLock Lock(&CriticalSection);
+		for (FStage& Stage : Stages)
+		{
+			Stage.Queue.Empty();
+			Stage.NumActive = 0;
+			Stage.WindowCompleted = 0;
+			Stage.WindowLatency = 0.0;
+			Stage.Published = {};
+		}
+		Joins.Empty();
+		AssignEntries.Empty();
+		ReadbackQueue->Reset();
+		NumAssignHeld = 0;
+		NumAssignWaiting = 0;
+		Epoch++;
+	}
+
+	// With the queues empty and the epoch bumped, finishing workers start nothing new. The running ones still use
+	// their chunks until they return, outside of the lock since they take it in FinishStage.
+	TaskContext->CancelQueued();
+	TaskContext->FlushRunningTasks();
+
+	// Nothing uses the chunks anymore, they are up to their owner now
+	FScopeLock Lock(&CriticalSection);
+	InFlightChunks.Empty();
+}
+
+void FChunkPipeline::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	FScopeLock Lock(&CriticalSection);
+	Collector.AddReferencedObjects(InFlightChunks);
+}
+
+FChunkPipeline::FStageStats FChunkPipeline::GetStageStats(EChunkPipelineStage Stage) const
+{
+	FScopeLock Lock(&CriticalSection);
+
+	FStageStats Stats = Stages[static_cast<int32>(Stage)].Published;
+	Stats.Queued = GetQueuedLocked(Stage);
+	Stats.Active = Stages[static_cast<int32>(Stage)].NumActive;
+	return Stats;
+}
+
+int32 FChunkPipeline::GetNumInFlight() const
+{
+	FScopeLock Lock(&CriticalSection);
+	return GetNumInFlightLocked();
+}
+
+int32 FChunkPipeline::GetNumInFlightLocked() const
+{
+	int32 InFlight = 0;
+	for (int32 Index = 0; Index <= static_cast<int32>(EChunkPipelineStage::Surface); Index++)
+	{
+		InFlight += GetQueuedLocked(static_cast<EChunkPipelineStage>(Index)) + Stages[Index].NumActive;
+	}
+
+	// A chunk in the branches is queued or active in up to all of them at once
+	return InFlight + Joins.Num();
+}
+
+int32 FChunkPipeline::GetQueuedLocked(EChunkPipelineStage Stage) const
+{
+	const FStage& State = Stages[static_cast<int32>(Stage)];
+	switch (Stage)
+	{
+	case EChunkPipelineStage::Dispatch:
+		// The dispatch queue is the scheduler's, this one only holds the dispatched chunks
+		return 0;
+	case EChunkPipelineStage::Assign:
+		return State.Queue.Num() + NumAssignWaiting;
+	default:
+		return State.Queue.Num();
+	}
+}
+
+bool FChunkPipeline::CanStart(EChunkPipelineStage Stage) const
+{
+	const FStage& State = Stages[static_cast<int32>(Stage)];
+	if (State.NumActive >= State.Settings.MaxConcurrency)
+	{
+		return false;
+	}
+
+	// Room in the assign queue was reserved for the branches when their chunk left Surface
+	if (Stage == EChunkPipelineStage::Assign || IsBranchStage(Stage))
+	{
+		return true;
+	}
+
+	if (Stage == EChunkPipelineStage::Surface)
+	{
+		// A chunk leaving Surface enters every branch, and counts against the assign queue until all of them are done
+		for (const EChunkPipelineStage Branch : BranchStages)
+		{
+			if (GetQueuedLocked(Branch) + State.NumActive >= Stages[static_cast<int32>(Branch)].Settings.QueueCapacity)
+			{
+				return false;
+			}
+		}
+
+		const FStage& Assign = Stages[static_cast<int32>(EChunkPipelineStage::Assign)];
+		return GetQueuedLocked(EChunkPipelineStage::Assign) + Joins.Num() + State.NumActive < Assign.Settings.QueueCapacity;
+	}
+
+	// Everything this stage is working on has to fit into the next queue once it is done
+	const EChunkPipelineStage Next = NextStage(Stage);
+	return GetQueuedLocked(Next) + State.NumActive < Stages[static_cast<int32>(Next)].Settings.QueueCapacity;
+}
+
+void FChunkPipeline::Enqueue(EChunkPipelineStage Stage, UChunkObject* Chunk, EChunkTaskLane Lane)
+{
+	FEntry& Entry = Stages[static_cast<int32>(Stage)].Queue.AddDefaulted_GetRef();
+	Entry.Chunk = Chunk;
+	Entry.EnqueueTime = FPlatformTime::Seconds();
+	Entry.Lane = Lane;
+}
+
+int32 FChunkPipeline::FindNextEntry(const TArray<FEntry>& Queue)
+{
+	const int32 Index = Queue.IndexOfByPredicate([](const FEntry& Entry)
+	{
+		return Entry.Lane == EChunkTaskLane::Near;
+	});
+	return Index != INDEX_NONE ? Index : 0;
+}
+
+void FChunkPipeline::RecordExit(EChunkPipelineStage Stage, double EnqueueTime)
+{
+	FStage& State = Stages[static_cast<int32>(Stage)];
+	State.WindowCompleted++;
+	State.WindowLatency += FPlatformTime::Seconds() - EnqueueTime;
+}
+
+void FChunkPipeline::Release(UChunkObject* Chunk)
+{
+	InFlightChunks.RemoveSingleSwap(Chunk, EAllowShrinking::No);
+}
+
+void FChunkPipeline::LeaveDispatch(UChunkObject* Chunk, bool bReady)
+{
+	FStage& State = Stages[static_cast<int32>(EChunkPipelineStage::Dispatch)];
+
+	// Gone when the pipeline was reset meanwhile
+	const int32 Index = State.Queue.IndexOfByPredicate([&Chunk](const FEntry& Entry)
+	{
+		return Entry.Chunk == Chunk;
+	});
+	if (Index == INDEX_NONE)
+	{
+		return;
+	}
+
+	const FEntry Entry = State.Queue[Index];
+	RecordExit(EChunkPipelineStage::Dispatch, Entry.EnqueueTime);
+	State.NumActive--;
+	State.Queue.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+
+	if (bReady)
+	{
+		Enqueue(EChunkPipelineStage::Readback, Chunk, Entry.Lane);
+	}
+	else
+	{
+		Release(Chunk);
+	}
+}
+
+void FChunkPipeline::OnBatchDispatched(const TArray<TWeakObjectPtr<UChunkObject>>& Chunks, const TArray<FPlanetComputeShaderReadback>& Readbacks, uint32 InEpoch)
+{
+	check(IsInGameThread());
+
+	FScopeLock Lock(&CriticalSection);
+	for (int32 Index = 0; Index < Chunks.Num(); Index++)
+	{
+		// Chunks dispatched before a reset are no longer kept alive by the pipeline
+		if (InEpoch != Epoch)
+		{
+			if (UChunkObject* Chunk = Chunks[Index].Get())
+			{
+				Chunk->OnDispatchComplete(Readbacks[Index]);
+			}
+			continue;
+		}
+
+		UChunkObject* Chunk = Chunks[Index].Get(/* bEvenIfGarbage */ true);
+		check(Chunk);
+		Chunk->OnDispatchComplete(Readbacks[Index]);
+
+		// Waiting chunks are handed to the readback queue, anything else was retried (back to PENDING_GENERATION)
+		// or aborted by an invalid readback
+		if (Chunk->ChunkStatus == UChunkObject::EChunkStatus::WAITING_FOR_GPU)
+		{
+			if (!Chunk->GetAbortAsync())
+			{
+				ReadbackQueue->Watch(Chunk, Readbacks[Index]);
+				continue;
+			}
+
+			Chunk->ReleaseReadback();
+			Chunk->GenerationComplete();
+		}
+		LeaveDispatch(Chunk, false);
+	}
+}
+
+void FChunkPipeline::TickDispatch()
+{
+	// Chunks whose readback the render thread found ready since the last tick
+	FChunkReadbackQueue::FCompletion Completion;
+	while (ReadbackQueue->Dequeue(Completion))
+	{
+		UChunkObject* Chunk = Completion.Chunk;
+		const bool bAborted = Chunk->GetAbortAsync();
+		if (bAborted)
+		{
+			Chunk->ReleaseReadback();
+			Chunk->GenerationComplete();
+		}
+
+		LeaveDispatch(Chunk, !bAborted);
+	}
+}
+
+void FChunkPipeline::TickReadback()
+{
+	FStage& State = Stages[static_cast<int32>(EChunkPipelineStage::Readback)];
+
+	while (State.Queue.Num() > 0 && CanStart(EChunkPipelineStage::Readback))
+	{
+		const int32 EntryIndex = FindNextEntry(State.Queue);
+		const FEntry Entry = State.Queue[EntryIndex];
+		State.Queue.RemoveAt(EntryIndex, 1, EAllowShrinking::No);
+
+		UChunkObject* Chunk = Entry.Chunk;
+		if (Chunk->GetAbortAsync())
+		{
+			RecordExit(EChunkPipelineStage::Readback, Entry.EnqueueTime);
+			Chunk->ReleaseReadback();
+			Chunk->GenerationComplete();
+			Release(Chunk);
+			continue;
+		}
+
+		State.NumActive++;
+		Chunk->StartReadback([WeakPipeline = AsWeak(), Entry, CurrentEpoch = Epoch](bool bSuccess)
+		{
+			if (const TSharedPtr<FChunkPipeline> Pipeline = WeakPipeline.Pin())
+			{
+				Pipeline->FinishStage(Entry, EChunkPipelineStage::Readback, CurrentEpoch, bSuccess);
+			}
+		});
+	}
+}
+
+int32 FChunkPipeline::TickAssign(int32 MaxAssigning, TArray<double>& OutFinishedEnqueueTimes)
+{
+	int32 NumAssigning = 0;
+	for (const FEntry& Entry : AssignEntries)
+	{
+		NumAssigning += Entry.bStarted ? 1 : 0;
+	}
+
+	int32 NumWaiting = 0;
+	NumAssignHeld = 0;
+	for (int32 Index = 0; Index < AssignEntries.Num(); Index++)
+	{
+		FEntry& Entry = AssignEntries[Index];
+		UChunkObject* Chunk = Entry.Chunk;
+
+		bool bLeave = Chunk->GetAbortAsync();
+		if (!bLeave)
+		{
+			if (Chunk->bAssignHeld)
+			{
+				NumAssignHeld++;
+				continue;
+			}
+
+			// Still on its way to PENDING_ASSIGN through GenerationComplete, out of budget for this frame or out of slots
+			if (Chunk->ChunkStatus != UChunkObject::EChunkStatus::PENDING_ASSIGN ||
+				!FChunkFinalizeBudget::HasTime() ||
+				(!Entry.bStarted && NumAssigning >= MaxAssigning))
+			{
+				NumWaiting += Entry.bStarted ? 0 : 1;
+				continue;
+			}
+
+			if (!Entry.bStarted)
+			{
+				Entry.bStarted = true;
+				NumAssigning++;
+			}
+
+			Chunk->AssignComponents();
+			bLeave = Chunk->ChunkStatus != UChunkObject::EChunkStatus::PENDING_ASSIGN;
+		}
+
+		if (bLeave)
+		{
+			{
+				FScopeLock Lock(&CriticalSection);
+				Release(Chunk);
+			}
+			OutFinishedEnqueueTimes.Add(Entry.EnqueueTime);
+			NumAssigning -= Entry.bStarted ? 1 : 0;
+			AssignEntries.RemoveAt(Index--, 1, EAllowShrinking::No);
+		}
+	}
+	return NumWaiting;
+}
+
+void FChunkPipeline::UpdateStats()
+{
+	const double Now = FPlatformTime::Seconds();
+	const double Elapsed = Now - StatsWindowStart;
+	if (Elapsed < StatsWindowSeconds)
+	{
+		return;
+	}
+
+	for (FStage& State : Stages)
+	{
+		State.Published.Throughput = State.WindowCompleted / Elapsed;
+		State.Published.AverageLatencyMs = State.WindowCompleted > 0 ? State.WindowLatency / State.WindowCompleted * 1000.0 : 0.0;
+		State.WindowCompleted = 0;
+		State.WindowLatency = 0.0;
+	}
+	StatsWindowStart = Now;
+}
+
+void FChunkPipeline::Pump()
+{
+	FScopeLock Lock(&CriticalSection);
+
+	// Downstream first, so chunks leaving a stage make room before the previous one checks for it
+	for (int32 Index = static_cast<int32>(EChunkPipelineStage::RenderData); Index >= static_cast<int32>(EChunkPipelineStage::Surface); Index--)
+	{
+		const EChunkPipelineStage Stage = static_cast<EChunkPipelineStage>(Index);
+		FStage& State = Stages[Index];
+
+		while (State.Queue.Num() > 0 && CanStart(Stage))
+		{
+			const int32 EntryIndex = FindNextEntry(State.Queue);
+			const FEntry Entry = State.Queue[EntryIndex];
+			State.Queue.RemoveAt(EntryIndex, 1, EAllowShrinking::No);
+			State.NumActive++;
+
+			StartWorker(Stage, Entry);
+		}
+	}
+}
+
+void FChunkPipeline::StartWorker(EChunkPipelineStage Stage, const FEntry& Entry)
+{
+	TaskContext->Launch(Entry.Lane, [WeakPipeline = AsWeak(), Entry, Stage, CurrentEpoch = Epoch]()
+	{
+		// Kept alive by InFlightChunks until FinishStage lets go of it, and Reset waits for this task
+		UChunkObject* Chunk = Entry.Chunk;
+		const bool bSuccess = !Chunk->GetAbortAsync() && Chunk->RunPipelineStage(Stage);
+
+		if (const TSharedPtr<FChunkPipeline> Pipeline = WeakPipeline.Pin())
+		{
+			Pipeline->FinishStage(Entry, Stage, CurrentEpoch, bSuccess);
+		}
+	});
+}
+
+void FChunkPipeline::FinishStage(const FEntry& Entry, EChunkPipelineStage Stage, uint32 InEpoch, bool bSuccess)
+{
+	UChunkObject* Chunk = Entry.Chunk;
+	{
+		FScopeLock Lock(&CriticalSection);
+		if (InEpoch != Epoch)
+		{
+			// The pipeline was reset, whoever reset it owns the chunk now
+			return;
+		}
+
+		Stages[static_cast<int32>(Stage)].NumActive--;
+		RecordExit(Stage, Entry.EnqueueTime);
+
+		// Set once the chunk is out of the worker stages, for good or because it failed
+		bool bDone = !bSuccess && !IsBranchStage(Stage);
+		bool bFailed = !bSuccess;
+
+		if (IsBranchStage(Stage))
+		{
+			FJoin* Join = Joins.Find(Chunk);
+			if (ensure(Join))
+			{
+				Join->bFailed |= !bSuccess;
+				if (--Join->NumPending == 0)
+				{
+					bDone = true;
+					bFailed = Join->bFailed;
+					if (!bFailed)
+					{
+						Enqueue(EChunkPipelineStage::Assign, Chunk, Entry.Lane);
+					}
+					Joins.Remove(Chunk);
+				}
+			}
+		}
+		else if (bSuccess)
+		{
+			if (Stage == EChunkPipelineStage::Surface)
+			{
+				Joins.Add(Chunk, { static_cast<int32>(UE_ARRAY_COUNT(BranchStages)), false });
+				for (const EChunkPipelineStage Branch : BranchStages)
+				{
+					Enqueue(Branch, Chunk, Entry.Lane);
+				}
+			}
+			else
+			{
+				Enqueue(NextStage(Stage), Chunk, Entry.Lane);
+			}
+		}
+
+		// Still under the lock: once it is released the next stage may finish the chunk and let go of it
+		if (!bSuccess)
+		{
+			// Also stops the other branches still working on the chunk
+			Chunk->SetAbortAsync();
+		}
+
+		if (bDone)
+		{
+			// PENDING_ASSIGN for the assign stage to pick up, or cleans up on the game thread and ends up ABORTED
+			Chunk->GenerationComplete();
+			if (bFailed)
+			{
+				Release(Chunk);
+			}
+		}
+	}
+
+	Pump();
+}
@@ -0,0 +1,132 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2026 Maciej Tkaczewski
+
+#include "ChunkReadbackQueue.h"
+#include "ChunkObject.h"
+#include "RenderingThread.h"
+
+void FChunkReadbackQueue::Watch(UChunkObject* Chunk, const FPlanetComputeShaderReadback& Readback)
+{
+	check(IsInGameThread());
+
+	const void* Key = Readback.Mapping.IsValid() ? static_cast<const void*>(Readback.Mapping.Get()) : Readback.OutputBuffer.Get();
+
+	FScopeLock Lock(&CriticalSection);
+	FBatch& Batch = Batches.FindOrAdd(Key);
+	if (Batch.Chunks.Num() == 0)
+	{
+		Batch.Readback = Readback;
+		Batch.WatchTime = FPlatformTime::Seconds();
+	}
+	Batch.Chunks.Add(Chunk);
+}
+
+void FChunkReadbackQueue::EnqueuePoll()
+{
+	check(IsInGameThread());
+
+	{
+		FScopeLock Lock(&CriticalSection);
+		if (bPollPending || Batches.Num() == 0)
+		{
+			return;
+		}
+		bPollPending = true;
+	}
+
+	ENQUEUE_RENDER_COMMAND(PollChunkReadbacks)(
+		[WeakQueue = AsWeak()](FRHICommandListImmediate& RHICmdList)
+		{
+			if (const TSharedPtr<FChunkReadbackQueue> Queue = WeakQueue.Pin())
+			{
+				Queue->Poll();
+			}
+		});
+}
+
+void FChunkReadbackQueue::Poll()
+{
+	Poll([](const FPlanetComputeShaderReadback& Readback)
+	{
+		return Readback.IsReady();
+	});
+}
+
+void FChunkReadbackQueue::Poll(TFunctionRef<bool(const FPlanetComputeShaderReadback& Readback)> IsReady)
+{
+	const double StartTime = FPlatformTime::Seconds();
+
+	FScopeLock Lock(&CriticalSection);
+	bPollPending = false;
+
+	for (auto It = Batches.CreateIterator(); It; ++It)
+	{
+		FBatch& Batch = It.Value();
+		if (!IsReady(Batch.Readback))
+		{
+			continue;
+		}
+
+		const double Latency = StartTime - Batch.WatchTime;
+		for (UChunkObject* Chunk : Batch.Chunks)
+		{
+			Completions.Enqueue({ Chunk, Latency });
+			NumQueued++;
+			WindowCompleted++;
+			WindowLatency += Latency;
+		}
+		It.RemoveCurrent();
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	WindowPolls++;
+	WindowPollTime += Now - StartTime;
+	UpdateStats(Now);
+}
+
+bool FChunkReadbackQueue::Dequeue(FCompletion& OutCompletion)
+{
+	if (!Completions.Dequeue(OutCompletion))
+	{
+		return false;
+	}
+
+	FScopeLock Lock(&CriticalSection);
+	NumQueued--;
+	return true;
+}
+
+void FChunkReadbackQueue::Reset()
+{
+	FScopeLock Lock(&CriticalSection);
+	Batches.Empty();
+	Completions.Empty();
+	NumQueued = 0;
+}
+
+FChunkReadbackQueue::FStats FChunkReadbackQueue::GetStats() const
+{
+	FScopeLock Lock(&CriticalSection);
+
+	FStats Stats = Published;
+	Stats.Outstanding = Batches.Num();
+	Stats.Queued = NumQueued;
+	return Stats;
+}
+
+void FChunkReadbackQueue::UpdateStats(double Now)
+{
+	const double Elapsed = Now - StatsWindowStart;
+	if (Elapsed < StatsWindowSeconds)
+	{
+		return;
+	}
+
+	Published.AverageLatencyMs = WindowCompleted > 0 ? WindowLatency / WindowCompleted * 1000.0 : 0.0;
+	Published.AveragePollMs = WindowPolls > 0 ? WindowPollTime / WindowPolls * 1000.0 : 0.0;
+	WindowCompleted = 0;
+	WindowLatency = 0.0;
+	WindowPolls = 0;
+	WindowPollTime = 0.0;
+	StatsWindowStart = Now;
+}
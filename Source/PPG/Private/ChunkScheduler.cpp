@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2026 Maciej Tkaczewski
+
+#include "ChunkScheduler.h"
+#include "ChunkObject.h"
+
+void FChunkScheduler::Request(UChunkObject* Chunk, float Priority, EChunkTaskLane Lane)
+{
+	if (Chunk == nullptr)
+	{
+		return;
+	}
+
+	Queue.Add({ Chunk, Priority, Lane });
+}
+
+int32 FChunkScheduler::Dispatch(int32 MaxGenerations, FChunkPipeline& Pipeline)
+{
+	const auto HigherPriority = [](const FRequest& A, const FRequest& B)
+	{
+		return A.Priority > B.Priority;
+	};
+
+	Queue.Heapify(HigherPriority);
+
+	// Backpressure: the pipeline has no room while a later stage is saturated, new chunks would only pile up in front of it
+	const int32 Capacity = FMath::Min(MaxGenerations, Pipeline.GetDispatchCapacity());
+
+	// The chunk may have been aborted after it was queued
+	const auto CanStart = [](const FRequest& Request)
+	{
+		return IsValid(Request.Chunk) && !Request.Chunk->GetAbortAsync() && Request.Chunk->ChunkStatus == UChunkObject::EChunkStatus::PENDING_GENERATION;
+	};
+
+	int32 Started = 0;
+	while (Started < Capacity && Queue.Num() > 0)
+	{
+		FRequest Top;
+		Queue.HeapPop(Top, HigherPriority, EAllowShrinking::No);
+
+		if (!CanStart(Top))
+		{
+			continue;
+		}
+
+		Pipeline.Dispatch(Top.Chunk, Top.Lane);
+		Started++;
+	}
+
+	NumHeld = 0;
+	for (const FRequest& Request : Queue)
+	{
+		NumHeld += CanStart(Request) ? 1 : 0;
+	}
+
+	// Requests are rebuilt by the next traversal with up-to-date priorities
+	Queue.Reset();
+	return Started;
+}
+
+void FChunkScheduler::Reset()
+{
+	Queue.Empty();
+	NumHeld = 0;
+}
+
+float FChunkScheduler::ComputePriority(double Distance, double ChunkSize, bool bBlocking, float BlockingScale)
+{
+	// Distance is measured to the chunk center, so subtract half the chunk to get closer to its nearest edge
+	const double SurfaceDistance = FMath::Max(Distance - ChunkSize / 2.0, 1.0);
+	float Priority = static_cast<float>(ChunkSize / SurfaceDistance);
+
+	if (bBlocking)
+	{
+		Priority *= BlockingScale;
+	}
+
+	return Priority;
+}
@@ -0,0 +1,145 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2026 Maciej Tkaczewski
+
+#include "ChunkTaskContext.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Tasks/Task.h"
+
+void FChunkTaskContext::Configure(const FSettings& InSettings)
+{
+	FScopeLock Lock(&CriticalSection);
+	Settings = InSettings;
+
+	// Raised limits take effect right away
+	StartRunnable();
+}
+
+void FChunkTaskContext::Launch(EChunkTaskLane Lane, TUniqueFunction<void()> Task)
+{
+	FScopeLock Lock(&CriticalSection);
+	Queues[static_cast<int32>(Lane)].Add(MoveTemp(Task));
+	StartRunnable();
+}
+
+void FChunkTaskContext::CancelQueued()
+{
+	FScopeLock Lock(&CriticalSection);
+	for (TArray<TUniqueFunction<void()>>& Queue : Queues)
+	{
+		Queue.Empty();
+	}
+}
+
+void FChunkTaskContext::FlushRunningTasks()
+{
+	// Tasks finishing meanwhile may start queued ones, wait until nothing is left running
+	while (true)
+	{
+		TArray<UE::Tasks::FTask> Tasks;
+		{
+			FScopeLock Lock(&CriticalSection);
+			RunningTasks.RemoveAllSwap([](const UE::Tasks::FTask& Task) { return Task.IsCompleted(); });
+			if (RunningTasks.Num() == 0)
+			{
+				return;
+			}
+			Tasks = RunningTasks;
+		}
+		UE::Tasks::Wait(Tasks);
+	}
+}
+
+FChunkTaskContext::FLaneStats FChunkTaskContext::GetLaneStats(EChunkTaskLane Lane) const
+{
+	FScopeLock Lock(&CriticalSection);
+
+	FLaneStats Stats;
+	Stats.Queued = Queues[static_cast<int32>(Lane)].Num();
+	Stats.Running = NumRunning[static_cast<int32>(Lane)];
+	return Stats;
+}
+
+void FChunkTaskContext::StartRunnable()
+{
+	TArray<FPendingTask> Tasks;
+	PopRunnable(Tasks);
+	if (Tasks.Num() == 0)
+	{
+		return;
+	}
+
+	// Finished tasks are only dropped here and by FlushRunningTasks, keep the list from growing with every launch
+	RunningTasks.RemoveAllSwap([](const UE::Tasks::FTask& Task) { return Task.IsCompleted(); });
+	StartTasks(Tasks);
+}
+
+void FChunkTaskContext::PopRunnable(TArray<FPendingTask>& OutTasks)
+{
+	TArray<TUniqueFunction<void()>>& NearQueue = Queues[static_cast<int32>(EChunkTaskLane::Near)];
+	TArray<TUniqueFunction<void()>>& BackgroundQueue = Queues[static_cast<int32>(EChunkTaskLane::Background)];
+	int32& NumNear = NumRunning[static_cast<int32>(EChunkTaskLane::Near)];
+	int32& NumBackground = NumRunning[static_cast<int32>(EChunkTaskLane::Background)];
+
+	const int32 MaxWorkers = GetMaxWorkers();
+	while (NumNear + NumBackground < MaxWorkers)
+	{
+		// Near tasks jump the queue, background ones only get the slots they are allowed and Near does not need
+		if (NearQueue.Num() > 0)
+		{
+			OutTasks.Add({ EChunkTaskLane::Near, false, MoveTemp(NearQueue[0]) });
+			NearQueue.RemoveAt(0, 1, EAllowShrinking::No);
+			NumNear++;
+		}
+		else if (BackgroundQueue.Num() > 0 && NumBackground < Settings.MaxBackgroundWorkers)
+		{
+			OutTasks.Add({ EChunkTaskLane::Background, Settings.bLowPriorityBackground, MoveTemp(BackgroundQueue[0]) });
+			BackgroundQueue.RemoveAt(0, 1, EAllowShrinking::No);
+			NumBackground++;
+		}
+		else
+		{
+			break;
+		}
+	}
+}
+
+void FChunkTaskContext::StartTasks(TArray<FPendingTask>& Tasks)
+{
+	for (FPendingTask& Pending : Tasks)
+	{
+		// Background priority tasks run on the task system's workers with the lowest OS thread priority
+		LowLevelTasks::ETaskPriority Priority = LowLevelTasks::ETaskPriority::BackgroundHigh;
+		if (Pending.Lane == EChunkTaskLane::Background)
+		{
+			Priority = Pending.bLowPriority ? LowLevelTasks::ETaskPriority::BackgroundLow : LowLevelTasks::ETaskPriority::BackgroundNormal;
+		}
+
+		RunningTasks.Add(UE::Tasks::Launch(TEXT("PPG Chunk Task"), [WeakThis = AsWeak(), Lane = Pending.Lane, Task = MoveTemp(Pending.Task)]()
+		{
+			Task();
+
+			if (const TSharedPtr<FChunkTaskContext> This = WeakThis.Pin())
+			{
+				This->OnTaskFinished(Lane);
+			}
+		}, Priority));
+	}
+}
+
+void FChunkTaskContext::OnTaskFinished(EChunkTaskLane Lane)
+{
+	FScopeLock Lock(&CriticalSection);
+	NumRunning[static_cast<int32>(Lane)]--;
+	StartRunnable();
+}
+
+int32 FChunkTaskContext::GetMaxWorkers() const
+{
+	if (Settings.MaxWorkers > 0)
+	{
+		return Settings.MaxWorkers;
+	}
+
+	// Leave a worker for the engine's own background work
+	return FMath::Max(FTaskGraphInterface::Get().GetNumBackgroundThreads() - 1, 1);
+}
@@ -14,9 +14,15 @@
 #include "Nanite/NaniteFixupChunk.h"
 #endif
 
-TUniquePtr<FStaticMeshRenderData> FPlanetNaniteBuilder::CreateRenderData(bool& AbortAsync, bool RayTracingProxy, bool NaniteEnabled)
+TUniquePtr<FStaticMeshRenderData> FPlanetNaniteBuilder::CreateRenderData(const TVoxelAtomic<bool>& ShouldCancel, bool RayTracingProxy, bool NaniteEnabled)
 {
 	VOXEL_FUNCTION_COUNTER();
+
+	CancelFlag = &ShouldCancel;
+	ON_SCOPE_EXIT
+	{
+		CancelFlag = nullptr;
+	};
 	check(Mesh.Positions.Num() == Mesh.Normals.Num());
 	check(Mesh.Positions.Num() % 3 == 0 || (Mesh.Indices.Num() > 0 && Mesh.Indices.Num() % 3 == 0));
 
@@ -34,7 +40,7 @@ TUniquePtr<FStaticMeshRenderData> FPlanetNaniteBuilder::CreateRenderData(bool& A
 
 		TVoxelArray<TUniquePtr<FCluster>> AllClusters = CreateClusters();
 
-		if (AbortAsync == true)
+		if (IsCancelled())
 		{
 			return nullptr;
 		}
@@ -45,7 +51,7 @@ TUniquePtr<FStaticMeshRenderData> FPlanetNaniteBuilder::CreateRenderData(bool& A
 
 		TVoxelArray<TVoxelArray<TUniquePtr<FCluster>>> Pages = CreatePages(AllClusters, EncodingSettings);
 
-		if (AbortAsync == true)
+		if (IsCancelled())
 		{
 			return nullptr;
 		}
@@ -136,7 +142,7 @@ TUniquePtr<FStaticMeshRenderData> FPlanetNaniteBuilder::CreateRenderData(bool& A
 			}
 		}
 
-		if (AbortAsync == true)
+		if (IsCancelled())
 		{
 			// Cleanup Resources to avoid holding onto data if we abort
 			Resources = Nanite::FResources();
@@ -323,6 +329,11 @@ bool FPlanetNaniteBuilder::Build(FBuildData& BuildData)
 	int32 ClusterIndexOffset = 0;
 	for (int32 PageIndex = 0; PageIndex < BuildData.Pages.Num(); PageIndex++)
 	{
+		if (IsCancelled())
+		{
+			return false;
+		}
+
 		TVoxelArray<TUniquePtr<FCluster>>& PageClusters = BuildData.Pages[PageIndex];
 		ON_SCOPE_EXIT
 		{
@@ -505,6 +516,11 @@ bool FPlanetNaniteBuilder::Build(FBuildData& BuildData)
 	int32 ClusterIndexOffset = 0;
 	for (int32 PageIndex = 0; PageIndex < BuildData.Pages.Num(); PageIndex++)
 	{
+		if (IsCancelled())
+		{
+			return false;
+		}
+
 		TVoxelArray<TUniquePtr<FCluster>>& Clusters = BuildData.Pages[PageIndex];
 		ON_SCOPE_EXIT
 		{
@@ -682,6 +698,12 @@ TVoxelArray<TUniquePtr<Voxel::Nanite::FCluster>> FPlanetNaniteBuilder::CreateClu
 		{
 			VOXEL_SCOPE_COUNTER("Allocate cluster");
 
+			// Checked once per cluster, the caller sees the flag and drops the partial result
+			if (IsCancelled())
+			{
+				return AllClusters;
+			}
+
 			NewTriangleIndex = 0;
 
 			FCluster& Cluster = *AllClusters.Add_GetRef(MakeUnique<FCluster>());
@@ -804,6 +826,11 @@ TVoxelArray<TVoxelArray<TUniquePtr<Voxel::Nanite::FCluster>>> FPlanetNaniteBuild
 		int32 ClusterIndex = 0;
 		while (ClusterIndex < Clusters.Num())
 		{
+			if (IsCancelled())
+			{
+				return Pages;
+			}
+
 			TVoxelArray<TUniquePtr<FCluster>>& PageClusters = Pages.Emplace_GetRef();
 			int32 GpuSize = 0;
 
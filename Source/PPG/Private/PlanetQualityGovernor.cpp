@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2026 Maciej Tkaczewski
+
+#include "PlanetQualityGovernor.h"
+
+bool FPlanetQualityGovernor::Update(const FPlanetQualityGovernorSettings& Settings, const FSample& Sample)
+{
+	if (Sample.DeltaTime <= 0.0f)
+	{
+		return false;
+	}
+
+	// Every measurement relative to its target, 1 is right at the target
+	float Ratios[NumMeasurements];
+	Ratios[FrameTime] = Sample.DeltaTime * Settings.TargetFrameRate;
+	Ratios[Finalize] = static_cast<float>(Sample.FinalizeBacklog) / FMath::Max(Settings.MaxFinalizeBacklog, 1);
+	Ratios[Backlog] = static_cast<float>(Sample.Backlog) / FMath::Max(Settings.MaxChunkBacklog, 1);
+	Ratios[Memory] = Settings.MemoryBudgetMB > 0 ? static_cast<float>(Sample.UsedMemory / (1024.0 * 1024.0) / Settings.MemoryBudgetMB) : 0.0f;
+
+	// Exponential moving average, independent of the frame rate
+	const float Alpha = Settings.SmoothingTime > 0.0f ? 1.0f - FMath::Exp(-Sample.DeltaTime / Settings.SmoothingTime) : 1.0f;
+	Pressure = 0.0f;
+	for (int32 Index = 0; Index < NumMeasurements; Index++)
+	{
+		Smoothed[Index] = bHasSample ? FMath::Lerp(Smoothed[Index], Ratios[Index], Alpha) : Ratios[Index];
+		Pressure = FMath::Max(Pressure, Smoothed[Index]);
+	}
+	bHasSample = true;
+
+	// Between the headroom and the target the bias holds
+	if (Pressure > 1.0f)
+	{
+		Bias -= Settings.DecreaseRate * Sample.DeltaTime;
+	}
+	else if (Pressure < Settings.Headroom)
+	{
+		Bias += Settings.IncreaseRate * Sample.DeltaTime;
+	}
+	Bias = FMath::Clamp(Bias, Settings.MinLODBias, Settings.MaxLODBias);
+
+	// Reaching a bound always applies, so the bias cannot get stuck just short of it
+	const bool bAtBound = Bias == Settings.MinLODBias || Bias == Settings.MaxLODBias;
+	if (Bias == AppliedBias || (!bAtBound && FMath::Abs(Bias - AppliedBias) < Settings.BiasStep))
+	{
+		return false;
+	}
+
+	AppliedBias = Bias;
+	LODDistanceScale = FMath::Exp2(AppliedBias);
+	return true;
+}
+
+void FPlanetQualityGovernor::Reset()
+{
+	*this = FPlanetQualityGovernor();
+}
+
+float FPlanetQualityGovernor::GetFoliageDensityScale(const FPlanetQualityGovernorSettings& Settings) const
+{
+	// Foliage is only thinned out once the terrain detail is below the neutral bias
+	const float Alpha = Settings.MinLODBias < 0.0f ? FMath::Clamp(1.0f - AppliedBias / Settings.MinLODBias, 0.0f, 1.0f) : 1.0f;
+	return FMath::Lerp(Settings.MinFoliageDensityScale, Settings.MaxFoliageDensityScale, Alpha);
+}
@@ -16,6 +16,21 @@
 #include "FoliageSpawner.h"
 #include "Components/InstancedStaticMeshComponent.h"
 #include "Materials/Material.h"
+#include "VoxelMinimal.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "ComputeShader/Public/PlanetComputeShader/PlanetReadbackPool.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<bool> CVarPlanetShowChunkStats(
+	TEXT("ppg.ShowChunkStats"),
+	false,
+	TEXT("Print the chunk generation counters of every planet on screen, every frame."),
+	ECVF_Default);
+
+static_assert(static_cast<uint8>(EChunkReadbackFormat::Float) == static_cast<uint8>(EPlanetReadbackFormat::Float)
+	&& static_cast<uint8>(EChunkReadbackFormat::Compact16) == static_cast<uint8>(EPlanetReadbackFormat::Compact16)
+	&& static_cast<uint8>(EChunkReadbackFormat::Compact24) == static_cast<uint8>(EPlanetReadbackFormat::Compact24),
+	"EChunkReadbackFormat must mirror EPlanetReadbackFormat");
 
 namespace
 {
@@ -43,94 +58,354 @@ namespace
 			&& !BaseMaterial->IsCompilingOrHadCompileError(GMaxRHIFeatureLevel)
 			&& MaterialInterface->GetRenderProxy() != nullptr;
 	}
+
+	// Map a point on the planet cube to a unit direction, using the same deformation as the chunk generation
+	FVector CubeToSphereDirection(FVector CubePoint, double PlanetRadius)
+	{
+		// Transform to -1, 1 range
+		float RootChunkSize = PlanetRadius * 2.0 / sqrt(2.0);
+		CubePoint = CubePoint / (RootChunkSize / 2.0f);
+
+		// Apply deformation (makes distribution on sphere more uniform)
+		float deformation = 0.75;
+		CubePoint.X = tan(CubePoint.X * PI * deformation / 4.0);
+		CubePoint.Y = tan(CubePoint.Y * PI * deformation / 4.0);
+		CubePoint.Z = tan(CubePoint.Z * PI * deformation / 4.0);
+
+		// Normalize to make it a unit sphere
+		return CubePoint.GetSafeNormal();
+	}
 }
 
 
-void FChunkTree::GenerateChunks(int32 RecursionLevel, FIntVector ChunkRotation, FVector ChunkLocation, double LocalChunkSize, APlanetSpawner* Planet, FChunkTree* ParentGeneratedChunk)
+void FChunkTree::Initialize(const UPlanetData& PlanetData)
 {
+	Reset();
+
+	float chunkSize = (PlanetData.PlanetRadius * 2.0f) / FMath::Sqrt(2.0f);
+
+	// Center the planet at (0,0,0)
+	FVector ChunkLocation = FVector(0,0,0) - chunkSize / 2;
+
+	const FVector FaceLocations[NumFaces] = {
+		ChunkLocation,
+		FVector(ChunkLocation.X + chunkSize, ChunkLocation.Y, ChunkLocation.Z),
+		ChunkLocation,
+		FVector(ChunkLocation.X, ChunkLocation.Y, ChunkLocation.Z + chunkSize),
+		FVector(ChunkLocation.X, ChunkLocation.Y + chunkSize, ChunkLocation.Z + chunkSize),
+		FVector(ChunkLocation.X + chunkSize, ChunkLocation.Y, ChunkLocation.Z + chunkSize),
+	};
+	const FIntVector FaceRotations[NumFaces] = {
+		FIntVector(-1, 0, 0),
+		FIntVector(0, 0, -1),
+		FIntVector(0, -1, 0),
+		FIntVector(0, 0, 1),
+		FIntVector(0, 1, 0),
+		FIntVector(1, 0, 0),
+	};
+
+	// Roots occupy the first NumFaces slots, every later allocation is a block of four siblings
+	Nodes.SetNum(NumFaces);
+	ChunkObjects.SetNum(NumFaces);
+	RefineChunks.SetNum(NumFaces);
+	for (int32 Face = 0; Face < NumFaces; Face++)
+	{
+		FChunkTreeNode& Root = Nodes[Face];
+		Root.ChunkSize = chunkSize;
+		Root.ChunkLocation = FaceLocations[Face];
+		Root.ChunkRotation = FaceRotations[Face];
+	}
+}
 
-	bool bChildChunksReady = true;
-	
-	if (ChunkObject != nullptr)
+int32 FChunkTree::AllocateChildren(int32 NodeIndex, const UPlanetData& PlanetData)
+{
+	int32 FirstChild;
+	if (FreeBlocks.Num() > 0)
 	{
-		TArray<FChunkTree*> ChildChunks;
-		FindConfiguredChunks(ChildChunks, false, true);
-		
-		if (ChildChunks.IsEmpty())
+		FirstChild = FreeBlocks.Pop(EAllowShrinking::No);
+	}
+	else
+	{
+		FirstChild = Nodes.AddDefaulted(4);
+		ChunkObjects.AddDefaulted(4);
+		RefineChunks.AddDefaulted(4);
+	}
+
+	// Nodes may have been reallocated, only take the reference now
+	const FChunkTreeNode& Parent = Nodes[NodeIndex];
+	const double ChildSize = Parent.ChunkSize / 2;
+	const FVector ChildOffsets[4] = {
+		FVector(0.0f, 0.0f, 0.0f),
+		FVector(ChildSize, 0.0f, 0.0f),
+		FVector(0.0f, ChildSize, 0.0f),
+		FVector(ChildSize, ChildSize, 0.0f),
+	};
+
+	for (int32 i = 0; i < 4; i++)
+	{
+		FChunkTreeNode& Child = Nodes[FirstChild + i];
+		Child = FChunkTreeNode();
+		Child.ChunkSize = ChildSize;
+		Child.Level = Parent.Level + 1;
+		Child.Parent = NodeIndex;
+		Child.ChunkRotation = Parent.ChunkRotation;
+		Child.ChunkLocation = PlanetData.PlanetTransformLocation(Parent.ChunkLocation, Parent.ChunkRotation, ChildOffsets[i]);
+		ChunkObjects[FirstChild + i] = nullptr;
+		RefineChunks[FirstChild + i] = nullptr;
+	}
+
+	Nodes[NodeIndex].FirstChild = FirstChild;
+	return FirstChild;
+}
+
+void FChunkTree::FreeChildren(int32 NodeIndex)
+{
+	const int32 FirstChild = Nodes[NodeIndex].FirstChild;
+	if (FirstChild == INDEX_NONE)
+	{
+		return;
+	}
+
+	for (int32 i = 0; i < 4; i++)
+	{
+		check(ChunkObjects[FirstChild + i] == nullptr && RefineChunks[FirstChild + i] == nullptr);
+		FreeChildren(FirstChild + i);
+	}
+
+	Nodes[NodeIndex].FirstChild = INDEX_NONE;
+	FreeBlocks.Add(FirstChild);
+}
+
+void FChunkTree::GenerateChunks(APlanetSpawner* Planet)
+{
+	FChunkPlanContext Context;
+	Context.Planet = Planet;
+	Context.bGenerationMaterialReady = Planet->IsGenerationMaterialReady();
+	Context.Now = FPlatformTime::Seconds();
+
+	SweepRetiredChunks();
+
+	// Planning: nodes above ParallelPlanningLevel are planned here, the subtrees below them on worker threads.
+	// Every subtree only touches its own nodes, and nothing in the tree changes until the apply phase.
+	FChunkTreePlan Plan;
+	const int32 SubtreeLevel = Planet->bParallelLODPlanning ? Planet->ParallelPlanningLevel : MAX_int32;
+	for (int32 Face = 0; Face < NumFaces; Face++)
+	{
+		if (SubtreeLevel <= 0)
 		{
-			bChildChunksReady = false;
+			Plan.Subtrees.Add({ Face, INDEX_NONE });
 		}
 		else
 		{
-			for (int32 i = 0; i < ChildChunks.Num(); i++)
-			{
-				if (ChildChunks[i]->ChunkObject->ChunkStatus != UChunkObject::EChunkStatus::READY)
-				{
-					bChildChunksReady = false;
-					break;
-				}
-			}
+			PlanChunks(Face, Context, INDEX_NONE, SubtreeLevel, Plan);
 		}
 	}
-	
-	FVector ChunkLocalOrigin = FVector(LocalChunkSize / 2, LocalChunkSize / 2, 0.0f);
-	FVector ChunkOriginLocation = Planet->PlanetData->PlanetTransformLocation(ChunkLocation, ChunkRotation, ChunkLocalOrigin);
 
-	// Transform ChunkOriginLocation to -1, 1 range
-	float RootChunkSize = Planet->PlanetData->PlanetRadius * 2.0 / sqrt(2.0);
-	ChunkOriginLocation = ChunkOriginLocation / (RootChunkSize / 2.0f);
+	TArray<TArray<FChunkTreeAction>> SubtreeActions;
+	SubtreeActions.SetNum(Plan.Subtrees.Num());
+	Voxel::ParallelFor(Plan.Subtrees.Num(), [&](const int32 Index)
+	{
+		FChunkTreePlan SubtreePlan;
+		PlanChunks(Plan.Subtrees[Index].Key, Context, Plan.Subtrees[Index].Value, MAX_int32, SubtreePlan);
+		SubtreeActions[Index] = MoveTemp(SubtreePlan.Actions);
+	});
+
+	// Deferred nodes were recorded top-down, so walking them backwards sees every child before its parent
+	for (int32 Index = Plan.DeferredNodes.Num() - 1; Index >= 0; Index--)
+	{
+		GatherChildrenSettled(Plan.DeferredNodes[Index], Planet->ViewOdometer);
+	}
 
-	// Apply deformation (makes distribution on sphere more uniform)
-	float deformation = 0.75;
-	ChunkOriginLocation.X = tan(ChunkOriginLocation.X * PI * deformation / 4.0);
-	ChunkOriginLocation.Y = tan(ChunkOriginLocation.Y * PI * deformation / 4.0);
-	ChunkOriginLocation.Z = tan(ChunkOriginLocation.Z * PI * deformation / 4.0);
+	// Apply: parents act before the subtrees below them
+	ApplyActions(Plan.Actions, Context);
+	for (const TArray<FChunkTreeAction>& Actions : SubtreeActions)
+	{
+		ApplyActions(Actions, Context);
+	}
+}
+
+void FChunkTree::PlanChunks(int32 NodeIndex, const FChunkPlanContext& Context, int32 ParentGeneratedNode, int32 SubtreeLevel, FChunkTreePlan& Plan)
+{
+	const APlanetSpawner* Planet = Context.Planet;
+	FChunkTreeNode* Node = &Nodes[NodeIndex];
+
+	// Incremental LOD: a settled subtree cannot change its split/merge decisions until the view
+	// has travelled further than the distance to its closest LOD boundary
+	if (Planet->bIncrementalLOD && Node->bSubtreeSettled && Planet->ViewOdometer - Node->EvaluatedOdometer < Node->SubtreeMargin)
+	{
+		return;
+	}
+	Node->bSubtreeSettled = false;
+
+	const int32 RecursionLevel = Node->Level;
+	const double LocalChunkSize = Node->ChunkSize;
+
+	// Children are ready when there is at least one chunk below this node and the first chunk on every path down is READY
+	bool bChildChunksReady = true;
+	
+	if (ChunkObjects[NodeIndex] != nullptr)
+	{
+		const int32 NumChildChunks = Node->NumChunks - 1;
+		bChildChunksReady = NumChildChunks > 0;
+
+		for (int32 i = 0; bChildChunksReady && i < 4; i++)
+		{
+			bChildChunksReady = Nodes[Node->FirstChild + i].NumUnreadyFrontier == 0;
+		}
+	}
 	
-	// Normalize to make it a unit sphere
-	ChunkOriginLocation.Normalize();
+	if (!Node->bCenterCached)
+	{
+		CacheNodeBounds(NodeIndex, *Planet->PlanetData);
+	}
 	
+	const UChunkObject* ChunkObject = ChunkObjects[NodeIndex];
+	const int32 FirstChild = Node->FirstChild;
 	if (ChunkObject != nullptr && (ChunkObject->ChunkStatus == UChunkObject::EChunkStatus::READY || ChunkObject->ChunkStatus == UChunkObject::EChunkStatus::PENDING_ASSIGN))
 	{
 		// If we have a ready chunk, use its max height
-		MaxChunkHeight = ChunkObject->GetChunkMaxHeight();
+		Node->MaxChunkHeight = ChunkObject->GetChunkMaxHeight();
 	}
-	else if (MaxChunkHeight < 0.01f && Child1 != nullptr && Child1->ChunkObject != nullptr && (Child1->MaxChunkHeight > 0.01f || Child2->MaxChunkHeight > 0.01f || Child3->MaxChunkHeight > 0.01f || Child4->MaxChunkHeight > 0.01f))
+	else if (Node->MaxChunkHeight < 0.01f && FirstChild != INDEX_NONE && ChunkObjects[FirstChild] != nullptr && (Nodes[FirstChild].MaxChunkHeight > 0.01f || Nodes[FirstChild + 1].MaxChunkHeight > 0.01f || Nodes[FirstChild + 2].MaxChunkHeight > 0.01f || Nodes[FirstChild + 3].MaxChunkHeight > 0.01f))
 	{
 		// If we don't have a ready chunk, but we have children, use their max heights
-		MaxChunkHeight = FMath::Max(Child1->MaxChunkHeight, Child2->MaxChunkHeight, Child3->MaxChunkHeight, Child4->MaxChunkHeight);
+		Node->MaxChunkHeight = FMath::Max(Nodes[FirstChild].MaxChunkHeight, Nodes[FirstChild + 1].MaxChunkHeight, Nodes[FirstChild + 2].MaxChunkHeight, Nodes[FirstChild + 3].MaxChunkHeight);
 	}
-	else if (MaxChunkHeight < 0.01f && ParentGeneratedChunk != nullptr)
+	else if (Node->MaxChunkHeight < 0.01f && ParentGeneratedNode != INDEX_NONE)
 	{
 		// If we don't have a ready chunk or children, use parent's max height
-		MaxChunkHeight = ParentGeneratedChunk->MaxChunkHeight;
+		Node->MaxChunkHeight = Nodes[ParentGeneratedNode].MaxChunkHeight;
+	}
+
+	if (ChunkObject != nullptr && (ChunkObject->ChunkStatus == UChunkObject::EChunkStatus::READY || ChunkObject->ChunkStatus == UChunkObject::EChunkStatus::PENDING_ASSIGN) && ChunkObject->GetHeightDeviation() >= 0.0f)
+	{
+		Node->HeightDeviation = ChunkObject->GetHeightDeviation();
+		Node->MaxCurvature = ChunkObject->GetMaxCurvature();
+	}
+	else if (Node->HeightDeviation < 0.0f && ParentGeneratedNode != INDEX_NONE)
+	{
+		// Until our own chunk is measured, assume the terrain is as rough as in the parent's chunk
+		Node->HeightDeviation = Nodes[ParentGeneratedNode].HeightDeviation;
+		Node->MaxCurvature = Nodes[ParentGeneratedNode].MaxCurvature;
+	}
+	const bool bFlat = Planet->IsFlatChunk(Node->HeightDeviation, Node->MaxCurvature, LocalChunkSize);
+
+	// Grid the node is displayed at once settled: its own chunk's, or the one its chunk will be created with. Previews are refined, not split.
+	int32 Quality = bFlat ? Planet->GetFlatQuality() : Planet->ChunkQuality;
+	if (ChunkObject != nullptr && !ChunkObject->bPreview)
+	{
+		Quality = ChunkObject->GetChunkQuality();
 	}
 	
 	
-	// Calculate distance from character to chunk center on the sphere.
-	FVector ChunkWorldPos = ChunkOriginLocation * (Planet->PlanetData->PlanetRadius + MaxChunkHeight);
-	float Distance = FVector::Dist(Planet->ViewLocation, ChunkWorldPos);
+	// Calculate distance from the views to chunk center on the sphere.
+	Node->WorldCenter = Node->CenterDirection * (Planet->PlanetData->PlanetRadius + Node->MaxChunkHeight);
+
+	// Levels outside [Min, Max) never depend on the views
+	const bool bViewDependent = RecursionLevel >= Planet->PlanetData->MinRecursionLevel && RecursionLevel < Planet->PlanetData->MaxRecursionLevel;
+	const bool bTestHorizon = Planet->bHorizonCulling && RecursionLevel >= Planet->HorizonCullingMinLevel;
+
+	// The node is refined to the union of what the views need. Distance is the weighted distance
+	// of the view that needs the chunk most, which drives its generation priority.
+	float Distance = UE_BIG_NUMBER;
+	bool IsWithinLODDistance = false;
+	bool bBelowHorizon = bTestHorizon;
+	bool bPrefetchChildren = false;
+	bool bAnyView = false;
+
+	// How far any view can move before the split decision flips
+	double DecisionMargin = UE_BIG_NUMBER;
+
+	for (const FPlanetLODView& View : Planet->LODViews)
+	{
+		if (View.Weight <= 0.0f)
+		{
+			continue;
+		}
+		bAnyView = true;
+
+		const double ViewDistance = FVector::Dist(View.Location, Node->WorldCenter);
+		Distance = FMath::Min(Distance, ViewDistance / View.Weight);
+
+		double SplitDistance = LocalChunkSize;
+		if (Planet->LODPolicy == EChunkLODPolicy::ScreenSpaceError)
+		{
+			SplitDistance = Planet->GetScreenSpaceSplitDistance(LocalChunkSize, Quality, Node->HeightDeviation, View.ProjectionScale);
+		}
+		// Hysteresis: a split node only merges once the view is clearly past the split threshold
+		SplitDistance *= View.Weight * (Node->bSplit ? Planet->MergeDistanceScale : Planet->SplitDistanceScale);
+		if (bFlat)
+		{
+			SplitDistance *= Planet->FlatSplitDistanceScale;
+		}
+		SplitDistance *= Planet->QualityGovernor.GetLODDistanceScale();
+
+		bool bViewSplit = ViewDistance - LocalChunkSize / 2 < SplitDistance;
+		double ViewMargin = FMath::Abs(ViewDistance - LocalChunkSize / 2 - SplitDistance);
+
+		// Nodes entirely below the horizon keep their coarse chunk
+		bool bHidden = false;
+		if (bTestHorizon)
+		{
+			double HorizonMargin = UE_BIG_NUMBER;
+			bHidden = Planet->IsBelowHorizon(View.Location, Node->CenterDirection, Node->AngularRadius, Node->MaxChunkHeight, HorizonMargin);
+
+			// Visibility only changes the outcome for nodes the distance rule would split
+			if (bViewSplit)
+			{
+				ViewMargin = FMath::Min(ViewMargin, HorizonMargin);
+			}
+
+			bViewSplit &= !bHidden;
+			bBelowHorizon &= bHidden;
+		}
+
+		// Leaves the view is heading into get their children generated ahead of time
+		if (Planet->bPredictivePrefetch && !Planet->bIsLoading && !bViewSplit && !bHidden)
+		{
+			const double PredictedDistance = FVector::Dist(View.PredictedLocation, Node->WorldCenter);
+			bPrefetchChildren |= PredictedDistance - LocalChunkSize / 2 < SplitDistance;
+
+			// The odometer also advances with the predicted location, so this margin stays valid
+			ViewMargin = FMath::Min(ViewMargin, FMath::Abs(PredictedDistance - LocalChunkSize / 2 - SplitDistance));
+		}
+
+		IsWithinLODDistance |= bViewSplit;
+		if (bViewDependent)
+		{
+			DecisionMargin = FMath::Min(DecisionMargin, ViewMargin);
+		}
+	}
+
+	bBelowHorizon &= bAnyView;
+	bPrefetchChildren &= bViewDependent && !IsWithinLODDistance;
+	Node->EvaluatedOdometer = Planet->ViewOdometer;
+	Node->SubtreeMargin = DecisionMargin;
+
+	// Chunks below a split node stay for at least MinChunkResidencyTime after one of them became READY.
+	// The hold expires without any view movement, so the node cannot settle while it lasts.
+	bool bHeldByResidency = false;
+	if (Node->bSplit && !IsWithinLODDistance && Planet->MinChunkResidencyTime > 0.0f)
+	{
+		bHeldByResidency = Context.Now - Node->LatestReadyTime < Planet->MinChunkResidencyTime;
+		IsWithinLODDistance = bHeldByResidency;
+	}
 
-	// Scale back to planet radius
-	ChunkOriginLocation *= Planet->PlanetData->PlanetRadius;
-	
-	bool IsWithinLODDistance = (Distance - LocalChunkSize / 2 < LocalChunkSize);
 	if ((RecursionLevel < Planet->PlanetData->MaxRecursionLevel && IsWithinLODDistance) || RecursionLevel < Planet->PlanetData->MinRecursionLevel)
 	{
 		// If we are within LOD distance, or below min recursion level, split chunk
-		
-		if (Child1 == nullptr)
+		Node->bSplit = true;
+
+		// The chunk is on its way out, its full quality version is not needed anymore
+		if (RefineChunks[NodeIndex] != nullptr)
 		{
-			Child1 = MakeShared<FChunkTree>();
-			Child2 = MakeShared<FChunkTree>();
-			Child3 = MakeShared<FChunkTree>();
-			Child4 = MakeShared<FChunkTree>();
+			Plan.Add(FChunkTreeAction::EType::DestroyRefinement, NodeIndex);
 		}
 		
-		FChunkTree* NewParentGeneratedChunk = ParentGeneratedChunk;
+		int32 NewParentGeneratedNode = ParentGeneratedNode;
 		if (ChunkObject != nullptr && ChunkObject->ChunkStatus == UChunkObject::EChunkStatus::READY)
 		{
-			NewParentGeneratedChunk = this;
-			ParentGeneratedChunk = nullptr;
+			NewParentGeneratedNode = NodeIndex;
 		}
 		
 		if (ChunkObject != nullptr)
@@ -141,170 +416,697 @@ void FChunkTree::GenerateChunks(int32 RecursionLevel, FIntVector ChunkRotation,
 				ChunkObject->ChunkStatus == UChunkObject::EChunkStatus::WAITING_FOR_GPU ||
 				ChunkObject->ChunkStatus == UChunkObject::EChunkStatus::PENDING_GENERATION)
 			{
-				ChunkObject->SelfDestruct();
-				ChunkObject = nullptr;
+				Plan.Add(FChunkTreeAction::EType::DestroyChunk, NodeIndex);
 			}
 			// Parent is READY, waiting for children
 			else if (ChunkObject->ChunkStatus == UChunkObject::EChunkStatus::READY && bChildChunksReady)
 			{
-				ChunkObject->SelfDestruct();
-				ChunkObject = nullptr;
+				Plan.Add(FChunkTreeAction::EType::DestroyChunk, NodeIndex);
 			}
 			// Active work needs to be aborted
 			else if (ChunkObject->ChunkStatus == UChunkObject::EChunkStatus::GENERATING)
 			{
-				ChunkObject->BeginSelfDestruct();
+				Plan.Add(FChunkTreeAction::EType::AbortChunk, NodeIndex);
 			}
 		}
-		
-		// Generate Children
-		Child1->GenerateChunks(RecursionLevel + 1, ChunkRotation, ChunkLocation, LocalChunkSize / 2, Planet, NewParentGeneratedChunk);
 
-		FVector NewChunkLocation = Planet->PlanetData->PlanetTransformLocation(ChunkLocation, ChunkRotation, FVector(LocalChunkSize / 2, 0.0f, 0.0f));
-		Child2->GenerateChunks(RecursionLevel + 1, ChunkRotation, NewChunkLocation, LocalChunkSize / 2, Planet, NewParentGeneratedChunk);
+		// The chunk actions above only run in the apply phase, so a node that still has a chunk settles on a later visit
+		Node->bSubtreeSettled = ChunkObject == nullptr && !bHeldByResidency;
+		
+		if (FirstChild == INDEX_NONE)
+		{
+			// New children are allocated and planned by the apply phase
+			Plan.Add(FChunkTreeAction::EType::Split, NodeIndex, NewParentGeneratedNode);
+			Node->bSubtreeSettled = false;
+		}
+		else
+		{
+			// Above the worker subtrees, children can only be gathered once the workers have finished
+			const bool bDeferGather = SubtreeLevel != MAX_int32;
+			if (bDeferGather)
+			{
+				Plan.DeferredNodes.Add(NodeIndex);
+			}
 
-		NewChunkLocation = Planet->PlanetData->PlanetTransformLocation(ChunkLocation, ChunkRotation, FVector(0.0f, LocalChunkSize / 2, 0.0f));
-		Child3->GenerateChunks(RecursionLevel + 1, ChunkRotation, NewChunkLocation, LocalChunkSize / 2, Planet, NewParentGeneratedChunk);
+			for (int32 i = 0; i < 4; i++)
+			{
+				if (RecursionLevel + 1 >= SubtreeLevel)
+				{
+					Plan.Subtrees.Add({ FirstChild + i, NewParentGeneratedNode });
+				}
+				else
+				{
+					PlanChunks(FirstChild + i, Context, NewParentGeneratedNode, SubtreeLevel, Plan);
+				}
+			}
 
-		NewChunkLocation = Planet->PlanetData->PlanetTransformLocation(ChunkLocation, ChunkRotation, FVector(LocalChunkSize / 2, LocalChunkSize / 2, 0.0f));
-		Child4->GenerateChunks(RecursionLevel + 1, ChunkRotation, NewChunkLocation, LocalChunkSize / 2, Planet, NewParentGeneratedChunk);
-		
+			if (!bDeferGather)
+			{
+				GatherChildrenSettled(NodeIndex, Planet->ViewOdometer);
+			}
+		}
 	}
 	else
 	{
+		Node->bSplit = false;
+
+		// Status the node's chunk will have after its own action
+		UChunkObject::EChunkStatus ChunkStatus = ChunkObject != nullptr ? ChunkObject->ChunkStatus : UChunkObject::EChunkStatus::PENDING_GENERATION;
+		bool bHasChunk = true;
+
+		// A reduced quality chunk whose own surface turned out not to be flat is replaced just like a preview.
+		// Decided once the chunk is READY, so the tree's NumUnrefinedChunks agrees with what gets refined.
+		const bool bNeedsRefinement = ChunkObject != nullptr && ChunkObject->bNeedsRefinement;
+
 		if (ChunkObject == nullptr)
 		{
-			
-			ChunkObject = NewObject<UChunkObject>(Planet, UChunkObject::StaticClass(), NAME_None, RF_Transient);
-			PendingFrames = 0;
-			
-			
-			ChunkObject->PlanetData = Planet->PlanetData;
-			ChunkObject->SetSharedResources(&Planet->ChunkSMCPool, &Planet->FoliageISMCPool, &Planet->WaterSMCPool, &Planet->Triangles);
-			ChunkObject->InitializeChunk(Planet->ChunkQuality, LocalChunkSize, RecursionLevel, ChunkLocation, ChunkOriginLocation, ChunkRotation, MaxChunkHeight, Planet->MaterialLayersNum, Planet->CloseWaterMesh, Planet->FarWaterMesh);
-			ChunkObject->SetFoliageActor(Planet->GetFoliageActor());
-			ChunkObject->bGenerateCollisions = Planet->bGenerateCollisions;
-			ChunkObject->bGenerateFoliage = Planet->bGenerateFoliage;
-			ChunkObject->bGenerateRayTracingProxy = Planet->bGenerateRayTracingProxy;
-			ChunkObject->bNaniteLandscape = Planet->bNaniteLandscape;
-			ChunkObject->CollisionDisableDistance = Planet->CollisionDisableDistance;
-			ChunkObject->FoliageDensityScale = Planet->GlobalFoliageDensityScale;
-			ChunkObject->CollisionSetup = Planet->CollisionSetup;
-		}
-		else if (ChunkObject->ChunkStatus == UChunkObject::EChunkStatus::PENDING_GENERATION)
-		{
-			if (!Planet->IsGenerationMaterialReady())
+			Plan.Add(FChunkTreeAction::EType::CreateChunk, NodeIndex);
+		}
+		else if (ChunkStatus == UChunkObject::EChunkStatus::PENDING_GENERATION)
+		{
+			if (!Context.bGenerationMaterialReady)
 			{
 				return;
 			}
 
-			// Delay generation start based on recursion level:
-			// Higher recursion chunks wait more frames to prioritize closer LODs.
-			// Delay = floor(RecursionLevel / 2) frames (e.g. level 2 → 1, level 10 → 5)
-			int32 RequiredDelay = RecursionLevel / 2;
-			if (PendingFrames >= RequiredDelay)
+			// Queue for the spawner's scheduler, which starts the highest priority chunks after the traversal.
+			// A chunk is blocking if a displayed parent waits for it to split, or displayed children wait for it to merge.
+			const bool bBlocking = (ParentGeneratedNode != INDEX_NONE && ChunkObjects[ParentGeneratedNode] != nullptr) || FirstChild != INDEX_NONE;
+			float Priority = FChunkScheduler::ComputePriority(Distance, LocalChunkSize, bBlocking, Planet->BlockingChunkPriorityScale);
+			if (bBelowHorizon)
 			{
-				ChunkObject->GenerateChunk();
-			}
-			else
-			{
-				PendingFrames++;
+				Priority *= Planet->OccludedChunkPriorityScale;
 			}
+			Plan.Add(FChunkTreeAction::EType::RequestGeneration, NodeIndex, INDEX_NONE, Priority, bBelowHorizon);
 		}
-		else if (ChunkObject->ChunkStatus == UChunkObject::EChunkStatus::ABORTED)
+		else if (ChunkStatus == UChunkObject::EChunkStatus::ABORTED)
 		{
-			ChunkObject->SelfDestruct();
-			ChunkObject = nullptr;
+			Plan.Add(FChunkTreeAction::EType::DestroyChunk, NodeIndex);
+			bHasChunk = false;
+		}
+		else if (ChunkStatus == UChunkObject::EChunkStatus::PENDING_ASSIGN && ChunkObject->bAssignHeld)
+		{
+			// The node now wants its prefetched chunk, the pipeline finalizes it within the frame budget
+			Plan.Add(FChunkTreeAction::EType::ReleaseAssign, NodeIndex);
 		}
-		else if (ChunkObject->ChunkStatus == UChunkObject::EChunkStatus::PENDING_ASSIGN)
+		else if (ChunkStatus == UChunkObject::EChunkStatus::READY && bNeedsRefinement && Context.bGenerationMaterialReady)
 		{
-			if (CompletionsThisFrame < Planet->MaxChunkCompletionsPerFrame)
+			// The chunk stays on screen until its replacement is ready
+			float Priority = FChunkScheduler::ComputePriority(Distance, LocalChunkSize, false, 1.0f);
+			if (bBelowHorizon)
 			{
-				// Process pending chunks with rate limiting
-				ChunkObject->AssignComponents();
-				CompletionsThisFrame++;
+				Priority *= Planet->OccludedChunkPriorityScale;
 			}
+			Plan.Add(FChunkTreeAction::EType::RefineChunk, NodeIndex, INDEX_NONE, Priority, bBelowHorizon);
 		}
-		else if (ChunkObject->ChunkStatus == UChunkObject::EChunkStatus::WAITING_FOR_GPU)
+		
+		bool bHasChildren = FirstChild != INDEX_NONE;
+		if (bPrefetchChildren && bHasChunk && ChunkStatus == UChunkObject::EChunkStatus::READY && CanPrefetchChildren(NodeIndex))
 		{
-			ChunkObject->TickGPUReadback();
+			Plan.Add(FChunkTreeAction::EType::PrefetchChildren, NodeIndex, INDEX_NONE, Distance);
+			bHasChildren = true;
 		}
-		
-		if (ChunkObject != nullptr)
+		else if (bHasChunk && bHasChildren)
 		{
-			TArray<FChunkTree*> ChildChunks;
-			FindConfiguredChunks(ChildChunks, false, false);
-			
-			if (ChildChunks.IsEmpty())
+			if (Node->NumChunks - (ChunkObject != nullptr ? 1 : 0) == 0)
 			{
-				Child1.Reset();
-				Child2.Reset();
-				Child3.Reset();
-				Child4.Reset();
+				// Only our own chunk is left in the subtree
+				Plan.Add(FChunkTreeAction::EType::FreeChildren, NodeIndex);
+				bHasChildren = false;
 			}
 			else
 			{
+				TArray<int32> ChildChunks;
+				FindConfiguredChunks(NodeIndex, ChildChunks, false, false);
+
 				for (int32 i = 0; i < ChildChunks.Num(); i++)
 				{
-					if (ChildChunks[i]->ChunkObject->ChunkStatus == UChunkObject::EChunkStatus::ABORTED || ChildChunks[i]->ChunkObject->ChunkStatus == UChunkObject::EChunkStatus::PENDING_ASSIGN || ChildChunks[i]->ChunkObject->ChunkStatus == UChunkObject::EChunkStatus::WAITING_FOR_GPU || ChildChunks[i]->ChunkObject->ChunkStatus == UChunkObject::EChunkStatus::PENDING_GENERATION)
+					const UChunkObject* ChildChunk = ChunkObjects[ChildChunks[i]];
+					if (ChildChunk->ChunkStatus == UChunkObject::EChunkStatus::ABORTED || ChildChunk->ChunkStatus == UChunkObject::EChunkStatus::PENDING_ASSIGN || ChildChunk->ChunkStatus == UChunkObject::EChunkStatus::WAITING_FOR_GPU || ChildChunk->ChunkStatus == UChunkObject::EChunkStatus::PENDING_GENERATION)
 					{
-						ChildChunks[i]->ChunkObject->SelfDestruct();
-						ChildChunks[i]->ChunkObject = nullptr;
+						Plan.Add(FChunkTreeAction::EType::DestroyChunk, ChildChunks[i]);
 					}
-					else if (ChunkObject->ChunkStatus == UChunkObject::EChunkStatus::READY && ChildChunks[i]->ChunkObject->ChunkStatus == UChunkObject::EChunkStatus::READY)
+					else if (ChunkStatus == UChunkObject::EChunkStatus::READY && ChildChunk->ChunkStatus == UChunkObject::EChunkStatus::READY)
 					{
-						ChildChunks[i]->ChunkObject->SelfDestruct();
-						ChildChunks[i]->ChunkObject = nullptr;
+						Plan.Add(FChunkTreeAction::EType::DestroyChunk, ChildChunks[i]);
 					}
-					else if (ChildChunks[i]->ChunkObject->ChunkStatus == UChunkObject::EChunkStatus::GENERATING)
+					else if (ChildChunk->ChunkStatus == UChunkObject::EChunkStatus::GENERATING)
 					{
-						ChildChunks[i]->ChunkObject->BeginSelfDestruct();
+						Plan.Add(FChunkTreeAction::EType::AbortChunk, ChildChunks[i]);
 					}
 				}
 			}
 		}
+
+		// A leaf is settled once its full quality chunk is displayed and the replaced children are gone
+		Node->bSubtreeSettled = bHasChunk && ChunkStatus == UChunkObject::EChunkStatus::READY && !bHasChildren && !bNeedsRefinement;
+	}
+}
+
+void FChunkTree::GatherChildrenSettled(int32 NodeIndex, double ViewOdometer)
+{
+	// A split node is settled once its own chunk is gone and every child subtree is settled
+	FChunkTreeNode& Node = Nodes[NodeIndex];
+	for (int32 i = 0; i < 4; i++)
+	{
+		const FChunkTreeNode& Child = Nodes[Node.FirstChild + i];
+		Node.bSubtreeSettled &= Child.bSubtreeSettled;
+		Node.SubtreeMargin = FMath::Min(Node.SubtreeMargin, Child.SubtreeMargin - (ViewOdometer - Child.EvaluatedOdometer));
 	}
 }
 
-void FChunkTree::FindConfiguredChunks(TArray<FChunkTree*>& Chunks, bool IncludeSelf, bool bFindFirst)
+void FChunkTree::ApplyActions(TConstArrayView<FChunkTreeAction> Actions, const FChunkPlanContext& Context)
 {
-	if (IncludeSelf && ChunkObject != nullptr)
+	APlanetSpawner* Planet = Context.Planet;
+	for (const FChunkTreeAction& Action : Actions)
 	{
-		Chunks.Add(this);
+		UChunkObject* ChunkObject = ChunkObjects[Action.NodeIndex];
+		switch (Action.Type)
+		{
+		case FChunkTreeAction::EType::Split:
+		{
+			// Fresh children have nothing to reuse from the planning phase, plan them right away
+			const int32 ChildIndex = AllocateChildren(Action.NodeIndex, *Planet->PlanetData);
+			FChunkTreePlan ChildPlan;
+			for (int32 i = 0; i < 4; i++)
+			{
+				PlanChunks(ChildIndex + i, Context, Action.ParentGeneratedNode, MAX_int32, ChildPlan);
+			}
+			ApplyActions(ChildPlan.Actions, Context);
+			break;
+		}
+		case FChunkTreeAction::EType::CreateChunk:
+			CreateChunk(Action.NodeIndex, Planet);
+			break;
+		case FChunkTreeAction::EType::RequestGeneration:
+			Planet->ChunkScheduler.Request(ChunkObject, Action.Value, Action.bBackground ? EChunkTaskLane::Background : EChunkTaskLane::Near);
+			break;
+		case FChunkTreeAction::EType::DestroyChunk:
+			DestroyChunk(Action.NodeIndex);
+			break;
+		case FChunkTreeAction::EType::AbortChunk:
+			AbortChunk(Action.NodeIndex);
+			break;
+		case FChunkTreeAction::EType::ReleaseAssign:
+			ChunkObject->ReleaseAssign();
+			break;
+		case FChunkTreeAction::EType::PrefetchChildren:
+			PrefetchChildren(Action.NodeIndex, Planet, Action.Value);
+			break;
+		case FChunkTreeAction::EType::FreeChildren:
+			FreeChildren(Action.NodeIndex);
+			break;
+		case FChunkTreeAction::EType::RefineChunk:
+			RefineChunk(Action.NodeIndex, Planet, Action.Value, Action.bBackground ? EChunkTaskLane::Background : EChunkTaskLane::Near);
+			break;
+		case FChunkTreeAction::EType::DestroyRefinement:
+			DestroyRefinement(Action.NodeIndex);
+			break;
+		}
+	}
+}
+
+void FChunkTree::CacheNodeBounds(int32 NodeIndex, const UPlanetData& PlanetData)
+{
+	FChunkTreeNode& Node = Nodes[NodeIndex];
+	const double LocalChunkSize = Node.ChunkSize;
+	
+	FVector ChunkLocalOrigin = FVector(LocalChunkSize / 2, LocalChunkSize / 2, 0.0f);
+	Node.CenterDirection = CubeToSphereDirection(PlanetData.PlanetTransformLocation(Node.ChunkLocation, Node.ChunkRotation, ChunkLocalOrigin), PlanetData.PlanetRadius);
+
+	// Angle from the center to the farthest corner bounds the whole patch
+	const FVector Corners[4] = {
+		FVector(0.0f, 0.0f, 0.0f),
+		FVector(LocalChunkSize, 0.0f, 0.0f),
+		FVector(0.0f, LocalChunkSize, 0.0f),
+		FVector(LocalChunkSize, LocalChunkSize, 0.0f),
+	};
+	double MinCos = 1.0;
+	for (const FVector& Corner : Corners)
+	{
+		const FVector CornerDirection = CubeToSphereDirection(PlanetData.PlanetTransformLocation(Node.ChunkLocation, Node.ChunkRotation, Corner), PlanetData.PlanetRadius);
+		MinCos = FMath::Min(MinCos, FVector::DotProduct(Node.CenterDirection, CornerDirection));
+	}
+	Node.AngularRadius = FMath::Acos(FMath::Clamp(MinCos, -1.0, 1.0));
+	Node.bCenterCached = true;
+}
+
+UChunkObject* FChunkTree::NewChunkObject(int32 NodeIndex, APlanetSpawner* Planet, bool bPreview)
+{
+	if (!Nodes[NodeIndex].bCenterCached)
+	{
+		CacheNodeBounds(NodeIndex, *Planet->PlanetData);
+	}
+	const FChunkTreeNode& Node = Nodes[NodeIndex];
+	const FVector ChunkOriginLocation = Node.CenterDirection * Planet->PlanetData->PlanetRadius;
+
+	int32 Quality = Planet->ChunkQuality;
+	TArray<uint32>* ChunkTriangles = &Planet->Triangles;
+	if (bPreview)
+	{
+		Quality = Planet->GetPreviewQuality();
+		ChunkTriangles = &Planet->PreviewTriangles;
+	}
+	else if (Planet->IsFlatChunk(Node.HeightDeviation, Node.MaxCurvature, Node.ChunkSize))
+	{
+		Quality = Planet->GetFlatQuality();
+		ChunkTriangles = &Planet->FlatTriangles;
+	}
+
+	UChunkObject* ChunkObject = NewObject<UChunkObject>(Planet, UChunkObject::StaticClass(), NAME_None, RF_Transient);
+	
+	ChunkObject->PlanetData = Planet->PlanetData;
+	ChunkObject->SetSharedResources(&Planet->ChunkSMCPool, &Planet->FoliageISMCPool, &Planet->WaterSMCPool, ChunkTriangles);
+	ChunkObject->InitializeChunk(Quality, Node.ChunkSize, Node.Level, Node.ChunkLocation, ChunkOriginLocation, Node.ChunkRotation, Node.MaxChunkHeight, Planet->MaterialLayersNum, Planet->CloseWaterMesh, Planet->FarWaterMesh);
+	ChunkObject->SetFoliageActor(Planet->GetFoliageActor());
+	ChunkObject->bGenerateCollisions = Planet->bGenerateCollisions && !bPreview;
+	ChunkObject->bGenerateFoliage = Planet->bGenerateFoliage && !bPreview;
+	ChunkObject->bGenerateRayTracingProxy = Planet->bGenerateRayTracingProxy && !bPreview;
+	ChunkObject->bNaniteLandscape = Planet->bNaniteLandscape;
+	ChunkObject->CollisionDisableDistance = Planet->CollisionDisableDistance;
+	ChunkObject->FoliageDensityScale = Planet->GlobalFoliageDensityScale;
+	ChunkObject->CollisionSetup = Planet->CollisionSetup;
+	ChunkObject->bPreview = bPreview;
+	ChunkObject->ReadbackFormat = static_cast<EPlanetReadbackFormat>(Planet->ReadbackFormat);
+
+	return ChunkObject;
+}
+
+UChunkObject* FChunkTree::CreateChunk(int32 NodeIndex, APlanetSpawner* Planet, bool bAllowPreview)
+{
+	// Behind a loading screen nobody sees the preview, it would only delay the full quality chunk
+	const bool bPreview = bAllowPreview && Planet->bProgressiveRefinement && !Planet->IsBulkGenerating();
+
+	UChunkObject* ChunkObject = NewChunkObject(NodeIndex, Planet, bPreview);
+	AttachChunk(NodeIndex, ChunkObject);
+	return ChunkObject;
+}
+
+void FChunkTree::RefineChunk(int32 NodeIndex, APlanetSpawner* Planet, float Priority, EChunkTaskLane Lane)
+{
+	UChunkObject* Refinement = RefineChunks[NodeIndex];
+	if (Refinement == nullptr)
+	{
+		Refinement = NewChunkObject(NodeIndex, Planet, false);
+		Refinement->SetReplacedChunk(ChunkObjects[NodeIndex]);
+		RefineChunks[NodeIndex] = Refinement;
+	}
+
+	switch (Refinement->ChunkStatus)
+	{
+	case UChunkObject::EChunkStatus::PENDING_GENERATION:
+		Planet->ChunkScheduler.Request(Refinement, Priority, Lane);
+		break;
+	case UChunkObject::EChunkStatus::ABORTED:
+		// Started over on the next traversal
+		DestroyRefinement(NodeIndex);
+		break;
+	case UChunkObject::EChunkStatus::READY:
+	{
+		// Its components already replaced the preview's, now the node takes the chunk over as well
+		RefineChunks[NodeIndex] = nullptr;
+		ChunkObjects[NodeIndex]->SelfDestruct();
+		DetachChunk(NodeIndex);
+		// It became READY unattached, a flat quality refinement that is not flat after all is refined again
+		Refinement->bNeedsRefinement = Planet->NeedsRefinement(*Refinement, Nodes[NodeIndex].ChunkSize);
+		AttachChunk(NodeIndex, Refinement);
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+void FChunkTree::DestroyRefinement(int32 NodeIndex)
+{
+	UChunkObject* Refinement = RefineChunks[NodeIndex];
+	if (Refinement == nullptr)
+	{
+		return;
+	}
+	RefineChunks[NodeIndex] = nullptr;
+
+	if (UChunkObject::IsInFlight(Refinement->ChunkStatus))
+	{
+		WastedGenerations++;
+	}
+
+	// Running work still uses the chunk, it is destroyed once that work has dropped out
+	if (Refinement->ChunkStatus == UChunkObject::EChunkStatus::GENERATING || Refinement->ChunkStatus == UChunkObject::EChunkStatus::REMOVING)
+	{
+		Refinement->BeginSelfDestruct();
+		RetiredChunks.Add(Refinement);
+		return;
+	}
+
+	Refinement->SelfDestruct();
+}
+
+void FChunkTree::SweepRetiredChunks()
+{
+	for (int32 Index = RetiredChunks.Num() - 1; Index >= 0; Index--)
+	{
+		if (RetiredChunks[Index]->ChunkStatus == UChunkObject::EChunkStatus::ABORTED)
+		{
+			RetiredChunks[Index]->SelfDestruct();
+			RetiredChunks.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+		}
+	}
+}
+
+void FChunkTree::DestroyRefinements()
+{
+	for (TObjectPtr<UChunkObject>& Refinement : RefineChunks)
+	{
+		if (Refinement != nullptr)
+		{
+			Refinement->SelfDestruct();
+			Refinement = nullptr;
+		}
+	}
+
+	for (UChunkObject* Retired : RetiredChunks)
+	{
+		Retired->SelfDestruct();
+	}
+	RetiredChunks.Empty();
+}
+
+bool FChunkTree::CanPrefetchChildren(int32 NodeIndex) const
+{
+	// Only one level ahead, leftovers of a deeper subtree are cleaned up first
+	const int32 FirstChild = Nodes[NodeIndex].FirstChild;
+	if (FirstChild == INDEX_NONE)
+	{
+		return true;
+	}
+
+	for (int32 i = 0; i < 4; i++)
+	{
+		const UChunkObject* ChildChunk = ChunkObjects[FirstChild + i];
+		if (Nodes[FirstChild + i].FirstChild != INDEX_NONE || (ChildChunk != nullptr && (ChildChunk->ChunkStatus == UChunkObject::EChunkStatus::READY || ChildChunk->ChunkStatus == UChunkObject::EChunkStatus::REMOVING)))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void FChunkTree::PrefetchChildren(int32 NodeIndex, APlanetSpawner* Planet, double Distance)
+{
+	int32 ChildIndex = Nodes[NodeIndex].FirstChild;
+	if (ChildIndex == INDEX_NONE)
+	{
+		ChildIndex = AllocateChildren(NodeIndex, *Planet->PlanetData);
+	}
+
+	const float ParentMaxHeight = Nodes[NodeIndex].MaxChunkHeight;
+	for (int32 i = 0; i < 4; i++)
+	{
+		const int32 Child = ChildIndex + i;
+		UChunkObject* ChildChunk = ChunkObjects[Child];
+
+		if (ChildChunk == nullptr)
+		{
+			Nodes[Child].MaxChunkHeight = ParentMaxHeight;
+			CreateChunk(Child, Planet, false)->bAssignHeld = true;
+		}
+		else if (ChildChunk->ChunkStatus == UChunkObject::EChunkStatus::PENDING_GENERATION)
+		{
+			const float Priority = FChunkScheduler::ComputePriority(Distance, Nodes[Child].ChunkSize, false, 1.0f);
+			Planet->ChunkScheduler.Request(ChildChunk, Priority * Planet->PrefetchPriorityScale, EChunkTaskLane::Background);
+		}
+		else if (ChildChunk->ChunkStatus == UChunkObject::EChunkStatus::ABORTED)
+		{
+			DestroyChunk(Child);
+		}
+
+		// PENDING_ASSIGN is held until the node actually splits, then the regular traversal releases it
+	}
+}
+
+void FChunkTree::FindConfiguredChunks(int32 NodeIndex, TArray<int32>& Chunks, bool IncludeSelf, bool bFindFirst) const
+{
+	if (IncludeSelf && ChunkObjects[NodeIndex] != nullptr)
+	{
+		Chunks.Add(NodeIndex);
 		
 		if (bFindFirst)
 		{
 			return;
 		}
 	}
-	if (Child1)
+
+	const int32 FirstChild = Nodes[NodeIndex].FirstChild;
+	if (FirstChild != INDEX_NONE)
+	{
+		for (int32 i = 0; i < 4; i++)
+		{
+			FindConfiguredChunks(FirstChild + i, Chunks, true, bFindFirst);
+		}
+	}
+}
+		
+void FChunkTree::AttachChunk(int32 NodeIndex, UChunkObject* ChunkObject)
+{
+	check(ChunkObjects[NodeIndex] == nullptr && ChunkObject != nullptr);
+
+	ChunkObjects[NodeIndex] = ChunkObject;
+	ChunkObject->SetTreeNode(this, NodeIndex);
+
+	const UChunkObject::EChunkStatus Status = ChunkObject->ChunkStatus;
+	const bool bReady = Status == UChunkObject::EChunkStatus::READY;
+	PropagateCounts(NodeIndex, 1, bReady ? 1 : 0, UChunkObject::IsInFlight(Status) ? 1 : 0, bReady && ChunkObject->bNeedsRefinement ? 1 : 0);
+	UpdateFrontier(NodeIndex);
+}
+
+void FChunkTree::DetachChunk(int32 NodeIndex)
+{
+	UChunkObject* ChunkObject = ChunkObjects[NodeIndex];
+	if (ChunkObject == nullptr)
+	{
+		return;
+	}
+
+	ChunkObject->SetTreeNode(nullptr, INDEX_NONE);
+	ChunkObjects[NodeIndex] = nullptr;
+
+	const UChunkObject::EChunkStatus Status = ChunkObject->ChunkStatus;
+	const bool bReady = Status == UChunkObject::EChunkStatus::READY;
+	PropagateCounts(NodeIndex, -1, bReady ? -1 : 0, UChunkObject::IsInFlight(Status) ? -1 : 0, bReady && ChunkObject->bNeedsRefinement ? -1 : 0);
+	UpdateFrontier(NodeIndex);
+}
+
+void FChunkTree::DestroyChunk(int32 NodeIndex)
+{
+	if (UChunkObject* ChunkObject = ChunkObjects[NodeIndex])
+	{
+		// Generation was started but the result is thrown away before it was ever displayed
+		if (UChunkObject::IsInFlight(ChunkObject->ChunkStatus))
+		{
+			WastedGenerations++;
+		}
+
+		ChunkObject->SelfDestruct();
+		DetachChunk(NodeIndex);
+	}
+
+	DestroyRefinement(NodeIndex);
+}
+
+void FChunkTree::AbortChunk(int32 NodeIndex)
+{
+	if (UChunkObject* ChunkObject = ChunkObjects[NodeIndex])
+	{
+		WastedGenerations++;
+		ChunkObject->BeginSelfDestruct();
+	}
+}
+
+void FChunkTree::CancelSubtree(int32 NodeIndex)
+{
+	const FChunkTreeNode& Node = Nodes[NodeIndex];
+	if (Node.NumInFlightChunks == 0)
+	{
+		return;
+	}
+
+	if (UChunkObject* ChunkObject = ChunkObjects[NodeIndex])
+	{
+		if (UChunkObject::IsInFlight(ChunkObject->ChunkStatus))
+		{
+			ChunkObject->SetAbortAsync();
+		}
+	}
+
+	if (Node.FirstChild != INDEX_NONE)
+	{
+		for (int32 i = 0; i < 4; i++)
+		{
+			CancelSubtree(Node.FirstChild + i);
+		}
+	}
+}
+
+void FChunkTree::CancelAll()
+{
+	for (int32 Face = 0; Face < NumFaces && Face < Nodes.Num(); Face++)
+	{
+		CancelSubtree(Face);
+	}
+
+	for (UChunkObject* Refinement : RefineChunks)
+	{
+		if (Refinement != nullptr)
+		{
+			Refinement->SetAbortAsync();
+		}
+	}
+	for (UChunkObject* Retired : RetiredChunks)
+	{
+		Retired->SetAbortAsync();
+	}
+}
+
+void FChunkTree::OnChunkStatusChanged(int32 NodeIndex, UChunkObject::EChunkStatus OldStatus, UChunkObject::EChunkStatus NewStatus)
+{
+	UChunkObject* ChunkObject = ChunkObjects[NodeIndex];
+	const bool bWasUnrefined = OldStatus == UChunkObject::EChunkStatus::READY && ChunkObject->bNeedsRefinement;
+	if (NewStatus == UChunkObject::EChunkStatus::READY)
+	{
+		// Its roughness is known now. Chunks are created with their planet as outer.
+		const APlanetSpawner* Planet = ChunkObject->GetTypedOuter<APlanetSpawner>();
+		ChunkObject->bNeedsRefinement = Planet != nullptr ? Planet->NeedsRefinement(*ChunkObject, Nodes[NodeIndex].ChunkSize) : ChunkObject->bPreview;
+	}
+	const bool bIsUnrefined = NewStatus == UChunkObject::EChunkStatus::READY && ChunkObject->bNeedsRefinement;
+
+	const int32 ReadyDelta = (NewStatus == UChunkObject::EChunkStatus::READY ? 1 : 0) - (OldStatus == UChunkObject::EChunkStatus::READY ? 1 : 0);
+	const int32 InFlightDelta = (UChunkObject::IsInFlight(NewStatus) ? 1 : 0) - (UChunkObject::IsInFlight(OldStatus) ? 1 : 0);
+	const int32 UnrefinedDelta = (bIsUnrefined ? 1 : 0) - (bWasUnrefined ? 1 : 0);
+
+	if (ReadyDelta != 0 || InFlightDelta != 0 || UnrefinedDelta != 0)
+	{
+		PropagateCounts(NodeIndex, 0, ReadyDelta, InFlightDelta, UnrefinedDelta);
+	}
+
+	if (ReadyDelta != 0)
+	{
+		UpdateFrontier(NodeIndex);
+	}
+
+	if (NewStatus == UChunkObject::EChunkStatus::READY)
+	{
+		const double Now = FPlatformTime::Seconds();
+		for (int32 Index = NodeIndex; Index != INDEX_NONE; Index = Nodes[Index].Parent)
+		{
+			Nodes[Index].LatestReadyTime = Now;
+		}
+	}
+}
+
+void FChunkTree::PropagateCounts(int32 NodeIndex, int32 ChunksDelta, int32 ReadyDelta, int32 InFlightDelta, int32 UnrefinedDelta)
+{
+	for (int32 Index = NodeIndex; Index != INDEX_NONE; Index = Nodes[Index].Parent)
+	{
+		FChunkTreeNode& Node = Nodes[Index];
+		Node.NumChunks += ChunksDelta;
+		Node.NumReadyChunks += ReadyDelta;
+		Node.NumInFlightChunks += InFlightDelta;
+		Node.NumUnrefinedChunks += UnrefinedDelta;
+	}
+}
+
+void FChunkTree::UpdateFrontier(int32 NodeIndex)
+{
+	for (int32 Index = NodeIndex; Index != INDEX_NONE; Index = Nodes[Index].Parent)
+	{
+		FChunkTreeNode& Node = Nodes[Index];
+
+		int32 NumUnready = 0;
+		if (const UChunkObject* ChunkObject = ChunkObjects[Index])
+		{
+			NumUnready = ChunkObject->ChunkStatus == UChunkObject::EChunkStatus::READY ? 0 : 1;
+		}
+		else if (Node.FirstChild != INDEX_NONE)
+		{
+			for (int32 i = 0; i < 4; i++)
+			{
+				NumUnready += Nodes[Node.FirstChild + i].NumUnreadyFrontier;
+			}
+		}
+
+		// Ancestors only see this node through the sum, nothing changes above an unchanged value
+		if (NumUnready == Node.NumUnreadyFrontier && Index != NodeIndex)
+		{
+			break;
+		}
+		Node.NumUnreadyFrontier = NumUnready;
+	}
+}
+
+void FChunkTree::InvalidateSettled()
+{
+	for (FChunkTreeNode& Node : Nodes)
+	{
+		Node.bSubtreeSettled = false;
+	}
+}
+
+int32 FChunkTree::GetNumChunks() const
+{
+	int32 Num = 0;
+	for (int32 Face = 0; Face < NumFaces && Face < Nodes.Num(); Face++)
+	{
+		Num += Nodes[Face].NumChunks;
+	}
+	return Num;
+}
+
+int32 FChunkTree::GetNumReadyChunks() const
+{
+	int32 Num = 0;
+	for (int32 Face = 0; Face < NumFaces && Face < Nodes.Num(); Face++)
+	{
+		Num += Nodes[Face].NumReadyChunks;
+	}
+	return Num;
+}
+
+int32 FChunkTree::GetNumUnrefinedChunks() const
+{
+	int32 Num = 0;
+	for (int32 Face = 0; Face < NumFaces && Face < Nodes.Num(); Face++)
 	{
-		Child1->FindConfiguredChunks(Chunks, true, bFindFirst);
-		Child2->FindConfiguredChunks(Chunks, true, bFindFirst);
-		Child3->FindConfiguredChunks(Chunks, true, bFindFirst);
-		Child4->FindConfiguredChunks(Chunks, true, bFindFirst);
+		Num += Nodes[Face].NumUnrefinedChunks;
 	}
+	return Num;
 }
 		
 void FChunkTree::Reset()
 {
-	Child1.Reset();
-	Child2.Reset();
-	Child3.Reset();
-	Child4.Reset();
-}
+	WastedGenerations = 0;
 
-void FChunkTree::AddReferencedObjects(FReferenceCollector& Collector)
-{
-	if (ChunkObject)
+	for (UChunkObject* ChunkObject : ChunkObjects)
 	{
-		Collector.AddReferencedObject(ChunkObject);
+		if (ChunkObject != nullptr)
+		{
+			ChunkObject->SetTreeNode(nullptr, INDEX_NONE);
+		}
 	}
 
-	if (Child1) Child1->AddReferencedObjects(Collector);
-	if (Child2) Child2->AddReferencedObjects(Collector);
-	if (Child3) Child3->AddReferencedObjects(Collector);
-	if (Child4) Child4->AddReferencedObjects(Collector);
+	Nodes.Empty();
+	ChunkObjects.Empty();
+	RefineChunks.Empty();
+	RetiredChunks.Empty();
+	FreeBlocks.Empty();
+}
+
+void FChunkTree::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	// Free slots hold nullptr, so the whole pool can be reported in one go
+	Collector.AddReferencedObjects(ChunkObjects);
+	Collector.AddReferencedObjects(RefineChunks);
+	Collector.AddReferencedObjects(RetiredChunks);
 }
 
 
@@ -328,6 +1130,7 @@ void APlanetSpawner::BeginPlay()
 	Super::BeginPlay();
 
 	bIsLoading = true;
+	LoadingStartTime = 0.0;
 	
 	
 	if (SafetyCheck())
@@ -374,6 +1177,8 @@ void APlanetSpawner::RegeneratePlanet()
 void APlanetSpawner::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
 	ClearComponents();
+	FPlanetReadbackPool::Get().ClearHighWaterMark(this);
+	AppliedReadbackPoolHighWaterMarkMB = INDEX_NONE;
 	Super::EndPlay(EndPlayReason);
 }
 
@@ -430,6 +1235,8 @@ void APlanetSpawner::BeginDestroy()
 	UMaterial::OnMaterialCompilationFinished().Remove(OnMaterialCompilationFinishedDelegateHandle);
 	
 	ClearComponents();
+	FPlanetReadbackPool::Get().ClearHighWaterMark(this);
+	AppliedReadbackPoolHighWaterMarkMB = INDEX_NONE;
 	
 	Super::BeginDestroy();
 }
@@ -607,6 +1414,7 @@ void APlanetSpawner::HandleGenerationMaterialChanged()
 	SetActorTickEnabled(false);
 	bRegenerateWhenMaterialReady = false;
 	bIsLoading = true;
+	LoadingStartTime = 0.0;
 	ClearComponents();
 
 	if (!PlanetData || !PlanetData->GenerationMaterial)
@@ -651,23 +1459,24 @@ void APlanetSpawner::HandleGenerationMaterialChanged()
 
 void APlanetSpawner::ClearComponents()
 {
+	// Running worker tasks drop out at their next check instead of finishing chunks that are about to be destroyed
+	ChunkTree.CancelAll();
+
+	// Finishes the readback stages on the render thread, the pipeline reset then waits for the worker stages
 	FlushRenderingCommands();
+	ChunkScheduler.Reset();
+	ChunkPipeline->Reset();
+
 	// Destroy chunks
-	TArray<FChunkTree*> Chunks;
-	ChunkTree1.FindConfiguredChunks(Chunks, true, false);
-	ChunkTree2.FindConfiguredChunks(Chunks, true, false);
-	ChunkTree3.FindConfiguredChunks(Chunks, true, false);
-	ChunkTree4.FindConfiguredChunks(Chunks, true, false);
-	ChunkTree5.FindConfiguredChunks(Chunks, true, false);
-	ChunkTree6.FindConfiguredChunks(Chunks, true, false);
-	
-	for (FChunkTree* Chunk : Chunks)
+	ChunkTree.DestroyRefinements();
+	for (int32 NodeIndex = 0; NodeIndex < ChunkTree.ChunkObjects.Num(); NodeIndex++)
 	{
-		Chunk->ChunkObject->SetAbortAsync(true);
-		Chunk->ChunkObject->SelfDestruct();
-		Chunk->ChunkObject = nullptr;
+		if (UChunkObject* ChunkObject = ChunkTree.ChunkObjects[NodeIndex])
+		{
+			ChunkObject->SelfDestruct();
+			ChunkTree.DetachChunk(NodeIndex);
+		}
 	}
-	Chunks.Empty();
 
 	// Destroy foliage
 	if (FoliageActor != nullptr)
@@ -738,43 +1547,67 @@ void APlanetSpawner::Tick(float DeltaTime)
 		return;
 	}
 
+	if (bIsLoading && LoadingStartTime == 0.0)
+	{
+		LoadingStartTime = FPlatformTime::Seconds();
+	}
+
+	// Bulk mode finalizes in larger batches, nothing is on screen to hitch yet
+	FChunkFinalizeBudget::BeginFrame(IsBulkGenerating() ? BulkFinalizationBudgetMs : ChunkFinalizationBudgetMs);
 	BuildPlanet();
-	FChunkTree::CompletionsThisFrame = 0;
-
-	TArray<FChunkTree*> AllChunks;
-	ChunkTree1.FindConfiguredChunks(AllChunks, true, false);
-	ChunkTree2.FindConfiguredChunks(AllChunks, true, false);
-	ChunkTree3.FindConfiguredChunks(AllChunks, true, false);
-	ChunkTree4.FindConfiguredChunks(AllChunks, true, false);
-	ChunkTree5.FindConfiguredChunks(AllChunks, true, false);
-	ChunkTree6.FindConfiguredChunks(AllChunks, true, false);
+
+	// Readbacks and finalization of the chunks in flight, including the ones dispatched by BuildPlanet
+	ChunkPipeline->Tick();
+
+	UpdateQualityGovernor(DeltaTime);
+
+	// Counters are kept by the tree, no need to walk the chunks
+	const int32 NumChunks = ChunkTree.GetNumChunks();
 	
 #if WITH_EDITOR
 	// Print all chunks count
-	GEngine->AddOnScreenDebugMessage(-1, 0.f, FColor::Green, FString::Printf(TEXT("Total Chunks: %d"), AllChunks.Num()));
-#endif
-
-	if (bIsLoading)
+	GEngine->AddOnScreenDebugMessage(-1, 0.f, FColor::Green, FString::Printf(TEXT("Total Chunks: %d"), NumChunks));
+	if (CVarPlanetShowChunkStats.GetValueOnGameThread())
 	{
-		bool bAllReady = true;
-
-		if (AllChunks.Num() == 0)
+		GEngine->AddOnScreenDebugMessage(-1, 0.f, FColor::Green, FString::Printf(TEXT("Wasted Generations: %d"), ChunkTree.WastedGenerations));
+		GEngine->AddOnScreenDebugMessage(-1, 0.f, FColor::Green, FString::Printf(TEXT("Chunk Finalization: %.2f ms"), FChunkFinalizeBudget::GetSpentMs()));
+		GEngine->AddOnScreenDebugMessage(-1, 0.f, FColor::Green, FString::Printf(TEXT("Pipeline: %d held"), ChunkScheduler.GetNumHeld()));
+		for (int32 Stage = 0; Stage < static_cast<int32>(EChunkPipelineStage::Num); Stage++)
 		{
-			bAllReady = false;
+			const FChunkPipeline::FStageStats Stats = ChunkPipeline->GetStageStats(static_cast<EChunkPipelineStage>(Stage));
+			GEngine->AddOnScreenDebugMessage(-1, 0.f, FColor::Green, FString::Printf(TEXT("  %s: %d queued, %d active, %.1f ms, %.1f/s"),
+				LexToString(static_cast<EChunkPipelineStage>(Stage)), Stats.Queued, Stats.Active, Stats.AverageLatencyMs, Stats.Throughput));
 		}
-		
-		for (FChunkTree* CheckChunk : AllChunks)
+		const FChunkTaskContext::FLaneStats NearTasks = ChunkPipeline->GetTaskContext().GetLaneStats(EChunkTaskLane::Near);
+		const FChunkTaskContext::FLaneStats BackgroundTasks = ChunkPipeline->GetTaskContext().GetLaneStats(EChunkTaskLane::Background);
+		GEngine->AddOnScreenDebugMessage(-1, 0.f, FColor::Green, FString::Printf(TEXT("Chunk Tasks: near %d running, %d queued, background %d running, %d queued"),
+			NearTasks.Running, NearTasks.Queued, BackgroundTasks.Running, BackgroundTasks.Queued));
+		const FChunkReadbackQueue::FStats ReadbackQueue = ChunkPipeline->GetReadbackQueue().GetStats();
+		GEngine->AddOnScreenDebugMessage(-1, 0.f, FColor::Green, FString::Printf(TEXT("Readback Queue: %d outstanding, %d queued, %.1f ms latency, %.3f ms per poll"),
+			ReadbackQueue.Outstanding, ReadbackQueue.Queued, ReadbackQueue.AverageLatencyMs, ReadbackQueue.AveragePollMs));
+		const FPlanetReadbackPool::FStats ReadbackPool = FPlanetReadbackPool::Get().GetStats();
+		GEngine->AddOnScreenDebugMessage(-1, 0.f, FColor::Green, FString::Printf(TEXT("Readback Pool: %lld hits, %lld misses, %d pooled, %.1f MB resident (peak %.1f MB)"),
+			ReadbackPool.Hits, ReadbackPool.Misses, ReadbackPool.NumPooled, ReadbackPool.BytesResident / (1024.0 * 1024.0), ReadbackPool.PeakBytesResident / (1024.0 * 1024.0)));
+		if (QualityGovernorSettings.bEnabled)
 		{
-			if (CheckChunk->ChunkObject != nullptr && CheckChunk->ChunkObject->ChunkStatus != UChunkObject::EChunkStatus::READY)
-			{
-				bAllReady = false;
-				break;
-			}
+			GEngine->AddOnScreenDebugMessage(-1, 0.f, FColor::Green, FString::Printf(TEXT("Quality Governor: LOD bias %.2f, foliage %.2f, pressure %.2f"),
+				QualityGovernor.GetLODBias(), GlobalFoliageDensityScale, QualityGovernor.GetPressure()));
 		}
+	}
+#endif
+
+	if (bIsLoading)
+	{
+		// Previews and unrefined reduced quality chunks have no collision yet, loading is not done until they are replaced
+		const bool bAllReady = NumChunks > 0 && ChunkTree.GetNumReadyChunks() == NumChunks && ChunkTree.GetNumUnrefinedChunks() == 0;
 
 		if (bAllReady)
 		{
+			UE_LOG(LogTemp, Log, TEXT("PlanetSpawner: %s generated %d chunks in %.2f s%s"), *GetName(), NumChunks,
+				FPlatformTime::Seconds() - LoadingStartTime, IsBulkGenerating() ? TEXT(" (bulk)") : TEXT(""));
+
 			bIsLoading = false;
+			LoadingStartTime = 0.0;
 			OnPlanetGenerationFinished.Broadcast();
 		}
 	}
@@ -892,60 +1725,162 @@ void APlanetSpawner::BuildPlanet()
 		return;
 	}
 
-	if (UGameplayStatics::GetGlobalTimeDilation(GetWorld()) == 1 || GetWorld()->WorldType == EWorldType::Editor)
+	FVector PlayerViewLocation = FVector::ZeroVector;
+	FRotator PlayerViewRotation = FRotator::ZeroRotator;
+	bool bHasViewPoint = false;
+	FVector NewViewLocation = LODViews.Num() > 0 ? GetActorTransform().TransformPosition(LODViews[0].Location) : FVector::ZeroVector;
+
+	if (APlayerController* PC = UGameplayStatics::GetPlayerController(this, 0))
 	{
-		FVector PlayerViewLocation = FVector::ZeroVector;
-		FRotator PlayerViewRotation = FRotator::ZeroRotator;
-		bool bHasViewPoint = false;
+		PC->GetPlayerViewPoint(PlayerViewLocation, PlayerViewRotation);
+		bHasViewPoint = true;
+	}
 
-		if (APlayerController* PC = UGameplayStatics::GetPlayerController(this, 0))
+#if WITH_EDITOR
+	if (GetWorld() != nullptr && GetWorld()->WorldType == EWorldType::Editor)
+	{
+		FViewport* activeViewport = GEditor->GetActiveViewport();
+		FEditorViewportClient* EditorViewClient = (activeViewport != nullptr) ? (FEditorViewportClient*)activeViewport->GetClient() : nullptr;
+		if(EditorViewClient)
 		{
-			PC->GetPlayerViewPoint(PlayerViewLocation, PlayerViewRotation);
-			bHasViewPoint = true;
+			NewViewLocation = EditorViewClient->GetViewLocation();
 		}
+	}
+	else
+	{
+		NewViewLocation = bHasViewPoint ? PlayerViewLocation : FVector::ZeroVector;
+	}
+#else
+	NewViewLocation = bHasViewPoint ? PlayerViewLocation : FVector::ZeroVector;
+#endif
+	
+	NewViewLocation = UKismetMathLibrary::InverseTransformLocation(GetActorTransform(), NewViewLocation);
 
-#if WITH_EDITOR
-		if (GetWorld() != nullptr && GetWorld()->WorldType == EWorldType::Editor)
+	// The primary view is followed by the registered view sources
+	const int32 NumViews = 1 + ViewSources.Num();
+	bool bViewsChanged = false;
+	if (LODViews.Num() != NumViews)
+	{
+		LODViews.SetNum(NumViews);
+		bViewsChanged = true;
+	}
+
+	// Editing a LOD setting moves split distances everywhere, like a new view does
+	const uint32 NewLODSettingsHash = ComputeLODSettingsHash();
+	if (NewLODSettingsHash != LODSettingsHash)
+	{
+		LODSettingsHash = NewLODSettingsHash;
+		bViewsChanged = true;
+	}
+
+	const float CurrentFOV = GetCurrentFOV();
+	const double WorldTime = GetWorld()->GetTimeSeconds();
+	const int32 ViewportHeight = GetCurrentViewportHeight();
+
+	TArray<FVector, TInlineAllocator<4>> NewLocations;
+	TArray<FVector, TInlineAllocator<4>> NewPredictedLocations;
+	double MovedDistance = 0.0;
+
+	for (int32 ViewIndex = 0; ViewIndex < NumViews; ViewIndex++)
+	{
+		FPlanetLODView& View = LODViews[ViewIndex];
+		FVector Location = NewViewLocation;
+		float FOV = CurrentFOV;
+		float Weight = 1.0f;
+
+		if (ViewIndex > 0)
 		{
-			FViewport* activeViewport = GEditor->GetActiveViewport();
-			FEditorViewportClient* EditorViewClient = (activeViewport != nullptr) ? (FEditorViewportClient*)activeViewport->GetClient() : nullptr;
-			if(EditorViewClient)
+			const FPlanetViewSource& Source = ViewSources[ViewIndex - 1];
+			if (AActor* SourceActor = Source.Actor.Get())
+			{
+				FRotator SourceRotation;
+				SourceActor->GetActorEyesViewPoint(Location, SourceRotation);
+				Location = UKismetMathLibrary::InverseTransformLocation(GetActorTransform(), Location);
+				Weight = Source.Weight;
+				FOV = Source.FOVOverride > 0.0f ? Source.FOVOverride : CurrentFOV;
+			}
+			else
 			{
-				ViewLocation = EditorViewClient->GetViewLocation();
+				// Destroyed actors stay registered but stop contributing
+				Weight = 0.0f;
 			}
 		}
-		else
+
+		if (Weight != View.Weight)
 		{
-			ViewLocation = bHasViewPoint ? PlayerViewLocation : FVector::ZeroVector;
+			View.Weight = Weight;
+			bViewsChanged = true;
 		}
-#else
-		ViewLocation = bHasViewPoint ? PlayerViewLocation : FVector::ZeroVector;
-#endif
-		
-		ViewLocation = UKismetMathLibrary::InverseTransformLocation(GetActorTransform(), ViewLocation);
-		
-		float chunkSize = (PlanetData->PlanetRadius * 2.0f) / FMath::Sqrt(2.0f);
 
-		// Center the planet at (0,0,0)
-		FVector ChunkLocation = FVector(0,0,0) - chunkSize / 2;
+		FVector PredictedLocation = Location;
+		if (bPredictivePrefetch)
+		{
+			PredictedLocation += View.UpdateVelocity(Location, WorldTime, PrefetchHistoryDuration) * PrefetchTimeHorizon;
+		}
+
+		if (Weight > 0.0f)
+		{
+			MovedDistance = FMath::Max3(MovedDistance, FVector::Dist(Location, View.Location), FVector::Dist(PredictedLocation, View.PredictedLocation));
+		}
+		NewLocations.Add(Location);
+		NewPredictedLocations.Add(PredictedLocation);
+
+		if (LODPolicy == EChunkLODPolicy::ScreenSpaceError)
+		{
+			const float NewProjectionScale = ViewportHeight / (2.0f * FMath::Tan(FMath::DegreesToRadians(FOV) / 2.0f));
+			if (!FMath::IsNearlyEqual(NewProjectionScale, View.ProjectionScale, View.ProjectionScale * 0.01f))
+			{
+				// Zooming or resizing moves every split distance
+				View.ProjectionScale = NewProjectionScale;
+				bViewsChanged = true;
+			}
+		}
+	}
+
+	// Small movements are ignored by the LOD, chunks in flight are still ticked by the traversal.
+	// The odometer bounds the movement of every view and of its predicted location.
+	if (!bIncrementalLOD || bViewsChanged || MovedDistance >= LODUpdateDistanceThreshold)
+	{
+		ViewOdometer += MovedDistance;
+		for (int32 ViewIndex = 0; ViewIndex < NumViews; ViewIndex++)
+		{
+			LODViews[ViewIndex].Location = NewLocations[ViewIndex];
+			LODViews[ViewIndex].PredictedLocation = NewPredictedLocations[ViewIndex];
+		}
+	}
 
-		ChunkTree1.GenerateChunks(0, FIntVector(-1, 0, 0), ChunkLocation, chunkSize, this, nullptr);
-		ChunkTree2.GenerateChunks(0, FIntVector(0, 0, -1), FVector(ChunkLocation.X + chunkSize, ChunkLocation.Y, ChunkLocation.Z), chunkSize, this, nullptr);
-		ChunkTree3.GenerateChunks(0, FIntVector(0, -1, 0), ChunkLocation, chunkSize, this, nullptr);
-		ChunkTree4.GenerateChunks(0, FIntVector(0, 0, 1), FVector(ChunkLocation.X, ChunkLocation.Y, ChunkLocation.Z + chunkSize), chunkSize, this, nullptr);
-		ChunkTree5.GenerateChunks(0, FIntVector(0, 1, 0), FVector(ChunkLocation.X, ChunkLocation.Y + chunkSize, ChunkLocation.Z + chunkSize), chunkSize, this, nullptr);
-		ChunkTree6.GenerateChunks(0, FIntVector(1, 0, 0), FVector(ChunkLocation.X + chunkSize, ChunkLocation.Y, ChunkLocation.Z + chunkSize), chunkSize, this, nullptr);
+	if (bViewsChanged)
+	{
+		// Settled subtrees were evaluated against a different set of views or LOD settings
+		ChunkTree.InvalidateSettled();
+	}
+	
+	if (!ChunkTree.IsInitialized())
+	{
+		ChunkTree.Initialize(*PlanetData);
 	}
+
+	ChunkTree.GenerateChunks(this);
+
+	// Start the most important pending chunks collected during the traversal
+	ConfigurePipeline();
+	ChunkScheduler.Dispatch(IsBulkGenerating() ? MAX_int32 : MaxChunkGenerationsPerFrame, *ChunkPipeline);
 }
 
+uint32 APlanetSpawner::ComputeLODSettingsHash() const
+{
+	uint32 Hash = GetTypeHash(LODPolicy);
+	Hash = HashCombine(Hash, GetTypeHash(TargetPixelError));
+	Hash = HashCombine(Hash, GetTypeHash(SplitDistanceScale));
+	Hash = HashCombine(Hash, GetTypeHash(MergeDistanceScale));
+	Hash = HashCombine(Hash, GetTypeHash(FlatSplitDistanceScale));
+	Hash = HashCombine(Hash, GetTypeHash(bHorizonCulling));
+	Hash = HashCombine(Hash, GetTypeHash(HorizonCullingMinLevel));
+	return Hash;
+}
 
 void APlanetSpawner::DestroyChunkTrees() {
-	ChunkTree1.Reset();
-	ChunkTree2.Reset();
-	ChunkTree3.Reset();
-	ChunkTree4.Reset();
-	ChunkTree5.Reset();
-	ChunkTree6.Reset();
+	ChunkTree.Reset();
 }
 
 
@@ -984,29 +1919,9 @@ void APlanetSpawner::PrecomputeChunkData()
 	//==========================================================================
 	// Generate Triangle Index Buffer
 	//==========================================================================
-	Triangles.Empty();
-	const int32 VerticesPerEdge = ChunkQuality + 1;
-
-	for (int32 y = 0; y < VerticesPerEdge - 1; y++)
-	{
-		for (int32 x = 0; x < VerticesPerEdge - 1; x++)
-		{
-			const int32 V0 = x + y * VerticesPerEdge;
-			const int32 V1 = V0 + 1;
-			const int32 V2 = V0 + VerticesPerEdge;
-			const int32 V3 = V2 + 1;
-
-			// First triangle (V0 -> V2 -> V1)
-			Triangles.Add(V0);
-			Triangles.Add(V2);
-			Triangles.Add(V1);
-
-			// Second triangle (V1 -> V2 -> V3)
-			Triangles.Add(V1);
-			Triangles.Add(V2);
-			Triangles.Add(V3);
-		}
-	}
+	BuildGridTriangles(ChunkQuality, Triangles);
+	BuildGridTriangles(GetPreviewQuality(), PreviewTriangles);
+	BuildGridTriangles(GetFlatQuality(), FlatTriangles);
 
 	//==========================================================================
 	// Initialize Foliage Actor
@@ -1228,13 +2143,366 @@ void APlanetSpawner::AddReferencedObjects(UObject* InThis, FReferenceCollector&
 	
 	APlanetSpawner* This = CastChecked<APlanetSpawner>(InThis);
 	
-	This->ChunkTree1.AddReferencedObjects(Collector);
-	This->ChunkTree2.AddReferencedObjects(Collector);
-	This->ChunkTree3.AddReferencedObjects(Collector);
-	This->ChunkTree4.AddReferencedObjects(Collector);
-	This->ChunkTree5.AddReferencedObjects(Collector);
-	This->ChunkTree6.AddReferencedObjects(Collector);
+	This->ChunkTree.AddReferencedObjects(Collector);
+	This->ChunkPipeline->AddReferencedObjects(Collector);
+}
+
+int32 APlanetSpawner::GetCurrentViewportHeight()
+{
+	int32 Height = 1080;
+
+#if WITH_EDITOR
+	if (GEditor && GetWorld() && GetWorld()->WorldType == EWorldType::Editor)
+	{
+		if (FViewport* ActiveViewport = GEditor->GetActiveViewport())
+		{
+			Height = ActiveViewport->GetSizeXY().Y;
+		}
+		return FMath::Max(Height, 1);
+	}
+#endif
+
+	if (GetWorld())
+	{
+		if (const APlayerController* PC = GetWorld()->GetFirstPlayerController())
+		{
+			int32 SizeX = 0;
+			int32 SizeY = 0;
+			PC->GetViewportSize(SizeX, SizeY);
+			if (SizeY > 0)
+			{
+				Height = SizeY;
+			}
+		}
+	}
+
+	return Height;
 }
 
+double APlanetSpawner::GetScreenSpaceSplitDistance(double ChunkSize, int32 Quality, float HeightDeviation, float ProjectionScale) const
+{
+	// Geometric error of a chunk: the feature size its vertex grid cannot represent.
+	// Grid spacing grows with the chunk, and rougher terrain hides more detail between two vertices.
+	// Unmeasured terrain is assumed as rough as the noise allows.
+	const double Roughness = HeightDeviation >= 0.0f ? HeightDeviation : PlanetData->NoiseHeight;
+	const double GeometricError = (ChunkSize + Roughness) / FMath::Max(Quality, 1);
+
+	// Projected error in pixels is GeometricError * ProjectionScale / Distance, solve for the distance where it equals the target
+	return GeometricError * ProjectionScale / FMath::Max(TargetPixelError, 0.1f);
+}
+
+bool APlanetSpawner::IsBelowHorizon(const FVector& ViewLocation, const FVector& Direction, float AngularRadius, float MaxChunkHeight, double& OutMargin) const
+{
+	// Conservative occluder: nothing on the planet is lower than the deepest possible noise
+	const double OccluderRadius = FMath::Max(PlanetData->PlanetRadius - PlanetData->NoiseHeight, 1.0);
+	const double ViewHeight = ViewLocation.Size();
+
+	if (ViewHeight <= OccluderRadius)
+	{
+		// Inside the occluder the test is meaningless, re-check once the view climbs above it
+		OutMargin = OccluderRadius - ViewHeight;
+		return false;
+	}
+
+	// Unknown heights fall back to the highest possible terrain
+	const double TopHeight = MaxChunkHeight > 0.01f ? MaxChunkHeight : PlanetData->NoiseHeight;
+	const double TopRadius = FMath::Max(PlanetData->PlanetRadius + TopHeight, OccluderRadius);
+
+	// A point at TopRadius is visible while its angle from the view direction stays within
+	// the view's horizon angle plus the angle at which the point itself rises above the occluder
+	const double VisibleAngle = FMath::Acos(OccluderRadius / ViewHeight) + FMath::Acos(OccluderRadius / TopRadius);
+	const double CenterAngle = FMath::Acos(FMath::Clamp(FVector::DotProduct(ViewLocation / ViewHeight, Direction), -1.0, 1.0));
+	const double Slack = CenterAngle - AngularRadius - VisibleAngle;
+
+	// How far the view can move before the slack runs out. Moving D turns the view direction by less than D / (ViewHeight - D)
+	// and shifts the horizon angle by at most D * dAcos(R/h)/dh, which grows without limit as the view descends towards the
+	// occluder. So both rates are taken at the lowest height the view can reach, and the margin is capped to keep that height
+	// halfway between the view and the occluder.
+	const double MaxMargin = (ViewHeight - OccluderRadius) * 0.5;
+	const double LowestHeight = ViewHeight - MaxMargin;
+	const double HorizonDistance = FMath::Sqrt(LowestHeight * LowestHeight - OccluderRadius * OccluderRadius);
+	const double AnglePerDistance = 1.0 / LowestHeight + OccluderRadius / (LowestHeight * FMath::Max(HorizonDistance, UE_DOUBLE_SMALL_NUMBER));
+	OutMargin = FMath::Min(FMath::Abs(Slack) / AnglePerDistance, MaxMargin);
+
+	return Slack > 0.0;
+}
+
+FVector FPlanetLODView::UpdateVelocity(const FVector& NewLocation, double Now, double HistoryDuration)
+{
+	History.Add({ NewLocation, Now });
+	while (History.Num() > 2 && Now - History[0].Time > HistoryDuration)
+	{
+		History.RemoveAt(0, EAllowShrinking::No);
+	}
+
+	const FSample& Oldest = History[0];
+	const double Elapsed = Now - Oldest.Time;
+	if (Elapsed <= UE_KINDA_SMALL_NUMBER)
+	{
+		return FVector::ZeroVector;
+	}
+
+	// Average over the whole history so single-frame jitter does not throw the prediction around
+	return (NewLocation - Oldest.Location) / Elapsed;
+}
+
+void APlanetSpawner::RegisterViewSource(AActor* Actor, float Weight, float FOVOverride)
+{
+	if (Actor == nullptr)
+	{
+		return;
+	}
+
+	for (FPlanetViewSource& Source : ViewSources)
+	{
+		if (Source.Actor == Actor)
+		{
+			Source.Weight = Weight;
+			Source.FOVOverride = FOVOverride;
+			return;
+		}
+	}
+
+	FPlanetViewSource& Source = ViewSources.AddDefaulted_GetRef();
+	Source.Actor = Actor;
+	Source.Weight = Weight;
+	Source.FOVOverride = FOVOverride;
+}
+
+void APlanetSpawner::UnregisterViewSource(AActor* Actor)
+{
+	const int32 Index = ViewSources.IndexOfByPredicate([Actor](const FPlanetViewSource& Source) { return Source.Actor == Actor; });
+	if (Index == INDEX_NONE)
+	{
+		return;
+	}
+
+	ViewSources.RemoveAt(Index);
+
+	// Slot 0 is the primary view. The other views keep their slot and their velocity history.
+	if (LODViews.IsValidIndex(Index + 1))
+	{
+		LODViews.RemoveAt(Index + 1);
+	}
+
+	// Settled subtrees were evaluated with the removed view
+	ChunkTree.InvalidateSettled();
+}
+
+int32 APlanetSpawner::GetWastedGenerations() const
+{
+	return ChunkTree.WastedGenerations;
+}
+
+static FChunkPipelineStageStats ToStageStats(const FChunkPipeline::FStageStats& Stats)
+{
+	FChunkPipelineStageStats Result;
+	Result.Queued = Stats.Queued;
+	Result.Active = Stats.Active;
+	Result.AverageLatencyMs = Stats.AverageLatencyMs;
+	Result.Throughput = Stats.Throughput;
+	return Result;
+}
+
+FChunkPipelineStats APlanetSpawner::GetPipelineStats() const
+{
+	FChunkPipelineStats Stats;
+	Stats.Held = ChunkScheduler.GetNumHeld();
+	Stats.Dispatch = ToStageStats(ChunkPipeline->GetStageStats(EChunkPipelineStage::Dispatch));
+	Stats.Readback = ToStageStats(ChunkPipeline->GetStageStats(EChunkPipelineStage::Readback));
+	Stats.Surface = ToStageStats(ChunkPipeline->GetStageStats(EChunkPipelineStage::Surface));
+	Stats.Foliage = ToStageStats(ChunkPipeline->GetStageStats(EChunkPipelineStage::Foliage));
+	Stats.Collision = ToStageStats(ChunkPipeline->GetStageStats(EChunkPipelineStage::Collision));
+	Stats.RenderData = ToStageStats(ChunkPipeline->GetStageStats(EChunkPipelineStage::RenderData));
+	Stats.Assign = ToStageStats(ChunkPipeline->GetStageStats(EChunkPipelineStage::Assign));
+
+	const FChunkReadbackQueue::FStats QueueStats = ChunkPipeline->GetReadbackQueue().GetStats();
+	Stats.ReadbacksOutstanding = QueueStats.Outstanding;
+	Stats.ReadbacksQueued = QueueStats.Queued;
+	Stats.ReadbackLatencyMs = QueueStats.AverageLatencyMs;
+	Stats.ReadbackPollMs = QueueStats.AveragePollMs;
+
+	const FPlanetReadbackPool::FStats PoolStats = FPlanetReadbackPool::Get().GetStats();
+	Stats.ReadbackPoolHits = PoolStats.Hits;
+	Stats.ReadbackPoolMisses = PoolStats.Misses;
+	Stats.ReadbackPoolBytesResident = PoolStats.BytesResident;
+	return Stats;
+}
+
+void APlanetSpawner::BuildGridTriangles(int32 Quality, TArray<uint32>& OutTriangles)
+{
+	OutTriangles.Empty();
+	const int32 VerticesPerEdge = Quality + 1;
+
+	for (int32 y = 0; y < VerticesPerEdge - 1; y++)
+	{
+		for (int32 x = 0; x < VerticesPerEdge - 1; x++)
+		{
+			const int32 V0 = x + y * VerticesPerEdge;
+			const int32 V1 = V0 + 1;
+			const int32 V2 = V0 + VerticesPerEdge;
+			const int32 V3 = V2 + 1;
+
+			// First triangle (V0 -> V2 -> V1)
+			OutTriangles.Add(V0);
+			OutTriangles.Add(V2);
+			OutTriangles.Add(V1);
+
+			// Second triangle (V1 -> V2 -> V3)
+			OutTriangles.Add(V1);
+			OutTriangles.Add(V2);
+			OutTriangles.Add(V3);
+		}
+	}
+}
+
+void APlanetSpawner::UpdateQualityGovernor(float DeltaTime)
+{
+	if (!QualityGovernorSettings.bEnabled)
+	{
+		// Back to the configured detail
+		if (QualityGovernor.GetLODBias() != 0.0f)
+		{
+			QualityGovernor.Reset();
+			GlobalFoliageDensityScale = QualityGovernor.GetFoliageDensityScale(QualityGovernorSettings);
+			ChunkTree.InvalidateSettled();
+		}
+		return;
+	}
+
+	// Loading frame times say nothing about gameplay, and bulk generation ignores the limits anyway
+	if (bIsLoading)
+	{
+		return;
+	}
+
+	FPlanetQualityGovernor::FSample Sample;
+	Sample.DeltaTime = DeltaTime;
+	Sample.FinalizeBacklog = ChunkPipeline->GetStageStats(EChunkPipelineStage::Assign).Queued;
+	Sample.Backlog = ChunkScheduler.GetNumHeld();
+	if (QualityGovernorSettings.MemoryBudgetMB > 0)
+	{
+		Sample.UsedMemory = FPlatformMemory::GetStats().UsedPhysical;
+	}
+
+	if (QualityGovernor.Update(QualityGovernorSettings, Sample))
+	{
+		// Only new chunks pick up the foliage density, displayed ones keep theirs
+		GlobalFoliageDensityScale = QualityGovernor.GetFoliageDensityScale(QualityGovernorSettings);
+		ChunkTree.InvalidateSettled();
+
+		UE_LOG(LogTemp, Verbose, TEXT("PlanetSpawner: %s LOD bias %.2f, foliage density %.2f, pressure %.2f"), *GetName(),
+			QualityGovernor.GetLODBias(), GlobalFoliageDensityScale, QualityGovernor.GetPressure());
+	}
+}
+
+float APlanetSpawner::GetLODBias() const
+{
+	return QualityGovernor.GetLODBias();
+}
 
+int32 APlanetSpawner::GetPreviewQuality() const
+{
+	return FMath::Max(ChunkQuality / FMath::Max(PreviewQualityDivisor, 1), 1);
+}
+
+int32 APlanetSpawner::GetFlatQuality() const
+{
+	return FMath::Max(ChunkQuality / FMath::Max(FlatQualityDivisor, 1), 1);
+}
+
+bool APlanetSpawner::IsFlatChunk(float HeightDeviation, float MaxCurvature, double ChunkSize) const
+{
+	if (!bAdaptiveChunkQuality || HeightDeviation < 0.0f || MaxCurvature < 0.0f)
+	{
+		return false;
+	}
+
+	// Linear interpolation between vertices Spacing apart misses at most MaxCurvature * Spacing^2 / 8
+	const double Spacing = ChunkSize / GetFlatQuality();
+	const double SurfaceError = MaxCurvature * Spacing * Spacing / 8.0;
+	return HeightDeviation <= FlatMaxHeightDeviation && SurfaceError <= FlatMaxSurfaceError;
+}
+
+bool APlanetSpawner::NeedsRefinement(const UChunkObject& ChunkObject, double ChunkSize) const
+{
+	return ChunkObject.bPreview
+		|| (ChunkObject.GetChunkQuality() < ChunkQuality && !IsFlatChunk(ChunkObject.GetHeightDeviation(), ChunkObject.GetMaxCurvature(), ChunkSize));
+}
+
+FPlanetGenerationProgress APlanetSpawner::GetGenerationProgress() const
+{
+	FPlanetGenerationProgress Progress;
+	Progress.bLoading = bIsLoading;
+	Progress.bBulk = IsBulkGenerating();
+	// Same condition as the end of loading in Tick, a chunk waiting for its refinement is not done
+	Progress.ChunksReady = ChunkTree.GetNumReadyChunks() - ChunkTree.GetNumUnrefinedChunks();
+	Progress.ChunksRequired = ChunkTree.GetNumChunks();
+
+	if (!bIsLoading)
+	{
+		Progress.Fraction = 1.0f;
+		Progress.EstimatedSecondsRemaining = 0.0f;
+		return Progress;
+	}
+
+	Progress.Fraction = Progress.ChunksRequired > 0 ? static_cast<float>(Progress.ChunksReady) / Progress.ChunksRequired : 0.0f;
+
+	if (LoadingStartTime > 0.0)
+	{
+		Progress.ElapsedSeconds = FPlatformTime::Seconds() - LoadingStartTime;
+		if (Progress.ChunksReady > 0)
+		{
+			const float ChunksPerSecond = Progress.ChunksReady / FMath::Max(Progress.ElapsedSeconds, UE_KINDA_SMALL_NUMBER);
+			Progress.EstimatedSecondsRemaining = (Progress.ChunksRequired - Progress.ChunksReady) / ChunksPerSecond;
+		}
+	}
+	return Progress;
+}
+
+bool APlanetSpawner::IsBulkGenerating() const
+{
+	return bIsLoading && bBulkGenerationWhileLoading && GetWorld() != nullptr && GetWorld()->IsGameWorld();
+}
 
+void APlanetSpawner::ConfigurePipeline()
+{
+	const bool bBulk = IsBulkGenerating();
+
+	// In bulk mode only the in-flight limit bounds the pipeline, the stages take whatever reaches them
+	const auto ToStageSettings = [bBulk](const FChunkPipelineStageSettings& Settings)
+	{
+		FChunkPipeline::FStageSettings Result;
+		Result.MaxConcurrency = bBulk ? MAX_int32 : Settings.MaxConcurrency;
+		Result.QueueCapacity = bBulk ? MAX_int32 : Settings.QueueCapacity;
+		return Result;
+	};
+
+	ChunkPipeline->SetMaxInFlight(bBulk ? BulkMaxInFlightGenerations : MaxInFlightGenerations);
+	ChunkPipeline->SetMaxBatchSize(MaxChunksPerDispatch);
+	// Setting it locks the pool and may trim it, only do so when it changed
+	if (ReadbackPoolHighWaterMarkMB != AppliedReadbackPoolHighWaterMarkMB)
+	{
+		AppliedReadbackPoolHighWaterMarkMB = ReadbackPoolHighWaterMarkMB;
+		FPlanetReadbackPool::Get().SetHighWaterMark(this, static_cast<int64>(ReadbackPoolHighWaterMarkMB) * 1024 * 1024);
+	}
+	ChunkPipeline->Configure(EChunkPipelineStage::Readback, ToStageSettings(ReadbackStage));
+	ChunkPipeline->Configure(EChunkPipelineStage::Surface, ToStageSettings(SurfaceStage));
+	ChunkPipeline->Configure(EChunkPipelineStage::Foliage, ToStageSettings(FoliageStage));
+	ChunkPipeline->Configure(EChunkPipelineStage::Collision, ToStageSettings(CollisionStage));
+	ChunkPipeline->Configure(EChunkPipelineStage::RenderData, ToStageSettings(RenderDataStage));
+	ChunkPipeline->Configure(EChunkPipelineStage::Assign, ToStageSettings(AssignStage));
+
+	FChunkTaskContext::FSettings TaskSettings;
+	TaskSettings.MaxWorkers = MaxChunkWorkers;
+	TaskSettings.MaxBackgroundWorkers = MaxBackgroundChunkWorkers;
+	TaskSettings.bLowPriorityBackground = bLowPriorityBackgroundChunks;
+	if (bBulk)
+	{
+		// Every background worker, for both lanes
+		TaskSettings.MaxWorkers = FTaskGraphInterface::Get().GetNumBackgroundThreads();
+		TaskSettings.MaxBackgroundWorkers = TaskSettings.MaxWorkers;
+		TaskSettings.bLowPriorityBackground = false;
+	}
+	ChunkPipeline->GetTaskContext().Configure(TaskSettings);
+}
@@ -0,0 +1,146 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2026 Maciej Tkaczewski
+
+#include "Misc/AutomationTest.h"
+#include "ChunkPipeline.h"
+#include "ChunkObject.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ChunkPipelineTest
+{
+	// A chunk ready for FChunkPipeline::Dispatch, told apart by the X of its ChunkLocation
+	UChunkObject* MakeChunk(UPlanetData* PlanetData, int32 Id, int32 ChunkQuality, EPlanetReadbackFormat ReadbackFormat)
+	{
+		UChunkObject* Chunk = NewObject<UChunkObject>(GetTransientPackage(), NAME_None, RF_Transient);
+		Chunk->PlanetData = PlanetData;
+		Chunk->ReadbackFormat = ReadbackFormat;
+		Chunk->InitializeChunk(ChunkQuality, 1000.0f, 0, FVector(Id, 0.0, 0.0), FVector::ZeroVector, FIntVector(0, 0, 1), 0.0f, 0, nullptr, nullptr);
+		return Chunk;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChunkPipelineFlushDispatchesTest, "PPG.ChunkPipeline.FlushDispatches",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FChunkPipelineFlushDispatchesTest::RunTest(const FString& Parameters)
+{
+	using namespace ChunkPipelineTest;
+
+	UPlanetData* PlanetA = NewObject<UPlanetData>(GetTransientPackage(), NAME_None, RF_Transient);
+	UPlanetData* PlanetB = NewObject<UPlanetData>(GetTransientPackage(), NAME_None, RF_Transient);
+	PlanetB->PlanetRadius = PlanetA->PlanetRadius * 2.0f;
+
+	const TSharedRef<FChunkPipeline> Pipeline = MakeShared<FChunkPipeline>();
+	Pipeline->SetMaxBatchSize(3);
+
+	// Sees every batch, and sends the chunks back to PENDING_GENERATION the way a material that is not compiled yet does
+	TArray<TArray<int32>> Batches;
+	Pipeline->SetBatchDispatcher([&Batches](TArray<FPlanetComputeShaderDispatchParams> Params, TFunction<void(TArray<FPlanetComputeShaderReadback>)> OnDispatchComplete)
+	{
+		TArray<int32>& Batch = Batches.AddDefaulted_GetRef();
+		TArray<FPlanetComputeShaderReadback> Readbacks;
+		for (const FPlanetComputeShaderDispatchParams& Chunk : Params)
+		{
+			Batch.Add(FMath::RoundToInt32(Chunk.ChunkLocation.X));
+			Readbacks.AddDefaulted_GetRef().bRetryDispatch = true;
+		}
+		OnDispatchComplete(MoveTemp(Readbacks));
+	});
+
+	const TArray<UChunkObject*> Chunks = {
+		MakeChunk(PlanetA, 0, 16, EPlanetReadbackFormat::Float),
+		MakeChunk(PlanetA, 1, 16, EPlanetReadbackFormat::Float),
+		// Other planet
+		MakeChunk(PlanetB, 2, 16, EPlanetReadbackFormat::Float),
+		// Other grid size
+		MakeChunk(PlanetA, 3, 32, EPlanetReadbackFormat::Float),
+		MakeChunk(PlanetA, 4, 16, EPlanetReadbackFormat::Float),
+		// Over the batch size of the first batch
+		MakeChunk(PlanetA, 5, 16, EPlanetReadbackFormat::Float),
+		// Other readback format
+		MakeChunk(PlanetA, 6, 16, EPlanetReadbackFormat::Compact16),
+		MakeChunk(PlanetB, 7, 16, EPlanetReadbackFormat::Float)
+	};
+
+	for (UChunkObject* Chunk : Chunks)
+	{
+		Pipeline->Dispatch(Chunk, EChunkTaskLane::Near);
+	}
+
+	TestTrue(TEXT("Nothing is submitted before the flush"), Batches.IsEmpty());
+	TestEqual(TEXT("Dispatched chunks are in flight"), Pipeline->GetNumInFlight(), Chunks.Num());
+
+	Pipeline->FlushDispatches();
+
+	// Each batch starts at the oldest chunk left and takes what batches with it, in dispatch order
+	const TArray<TArray<int32>> Expected = { { 0, 1, 4 }, { 2, 7 }, { 3 }, { 5 }, { 6 } };
+	if (TestEqual(TEXT("Number of batches"), Batches.Num(), Expected.Num()))
+	{
+		for (int32 Index = 0; Index < Expected.Num(); Index++)
+		{
+			TestEqual(FString::Printf(TEXT("Chunks of batch %d"), Index), Batches[Index], Expected[Index]);
+		}
+	}
+
+	for (const UChunkObject* Chunk : Chunks)
+	{
+		TestEqual(TEXT("Retried chunks wait for the next dispatch"), Chunk->ChunkStatus, UChunkObject::EChunkStatus::PENDING_GENERATION);
+	}
+	TestEqual(TEXT("Retried chunks leave the pipeline"), Pipeline->GetNumInFlight(), 0);
+
+	Pipeline->FlushDispatches();
+	TestEqual(TEXT("A second flush has nothing to submit"), Batches.Num(), Expected.Num());
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChunkPipelineDispatchCapacityTest, "PPG.ChunkPipeline.DispatchCapacity",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FChunkPipelineDispatchCapacityTest::RunTest(const FString& Parameters)
+{
+	using namespace ChunkPipelineTest;
+
+	UPlanetData* PlanetData = NewObject<UPlanetData>(GetTransientPackage(), NAME_None, RF_Transient);
+
+	const TSharedRef<FChunkPipeline> Pipeline = MakeShared<FChunkPipeline>();
+	Pipeline->SetBatchDispatcher([](TArray<FPlanetComputeShaderDispatchParams> Params, TFunction<void(TArray<FPlanetComputeShaderReadback>)> OnDispatchComplete)
+	{
+		TArray<FPlanetComputeShaderReadback> Readbacks;
+		Readbacks.SetNum(Params.Num());
+		for (FPlanetComputeShaderReadback& Readback : Readbacks)
+		{
+			Readback.bRetryDispatch = true;
+		}
+		OnDispatchComplete(MoveTemp(Readbacks));
+	});
+
+	TestTrue(TEXT("Unbounded by default"), Pipeline->GetDispatchCapacity() > 1000);
+
+	Pipeline->SetMaxInFlight(4);
+	TestEqual(TEXT("Bounded by MaxInFlight"), Pipeline->GetDispatchCapacity(), 4);
+
+	Pipeline->Dispatch(MakeChunk(PlanetData, 0, 16, EPlanetReadbackFormat::Float), EChunkTaskLane::Near);
+	TestEqual(TEXT("Dispatched chunks count against MaxInFlight before their flush"), Pipeline->GetDispatchCapacity(), 3);
+
+	FChunkPipeline::FStageSettings DispatchSettings;
+	DispatchSettings.MaxConcurrency = 2;
+	Pipeline->Configure(EChunkPipelineStage::Dispatch, DispatchSettings);
+	TestEqual(TEXT("Bounded by the dispatch stage's concurrency"), Pipeline->GetDispatchCapacity(), 1);
+
+	// Every chunk on the GPU needs a readback slot
+	FChunkPipeline::FStageSettings ReadbackSettings;
+	ReadbackSettings.QueueCapacity = 1;
+	Pipeline->Configure(EChunkPipelineStage::Readback, ReadbackSettings);
+	TestEqual(TEXT("Bounded by the readback queue"), Pipeline->GetDispatchCapacity(), 0);
+
+	// Retried chunks leave the pipeline and give their room back
+	Pipeline->FlushDispatches();
+	TestEqual(TEXT("Nothing in flight after the flush"), Pipeline->GetNumInFlight(), 0);
+	TestEqual(TEXT("The readback queue bounds the capacity again"), Pipeline->GetDispatchCapacity(), 1);
+
+	return true;
+}
+
+#endif
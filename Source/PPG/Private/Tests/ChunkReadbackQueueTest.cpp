@@ -0,0 +1,84 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2026 Maciej Tkaczewski
+
+#include "Misc/AutomationTest.h"
+#include "ChunkReadbackQueue.h"
+#include "ChunkObject.h"
+#include "ComputeShader/Public/PlanetComputeShader/PlanetReadbackPool.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Readiness is decided by the test, the readbacks are never copied into
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChunkReadbackQueueBatchingTest, "PPG.ChunkReadbackQueue.Batching",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FChunkReadbackQueueBatchingTest::RunTest(const FString& Parameters)
+{
+	const TSharedRef<FPlanetReadbackPool> Pool = MakeShared<FPlanetReadbackPool>();
+	const TSharedRef<FChunkReadbackQueue> Queue = MakeShared<FChunkReadbackQueue>();
+
+	TArray<UChunkObject*> Chunks;
+	for (int32 Index = 0; Index < 4; Index++)
+	{
+		Chunks.Add(NewObject<UChunkObject>(GetTransientPackage(), NAME_None, RF_Transient));
+	}
+
+	// Chunks 0 and 1 are slices of one batch's buffer, chunk 2 has a batch of its own
+	FPlanetComputeShaderReadback BatchA;
+	BatchA.OutputBuffer = Pool->Acquire(1024, TEXT("BatchA"));
+	BatchA.Format = EPlanetReadbackFormat::Compact16;
+	FPlanetComputeShaderReadback BatchASecond = BatchA;
+	BatchASecond.VertexOffset = 64;
+	FPlanetComputeShaderReadback BatchB;
+	BatchB.OutputBuffer = Pool->Acquire(1024, TEXT("BatchB"));
+	BatchB.Format = EPlanetReadbackFormat::Compact16;
+
+	Queue->Watch(Chunks[0], BatchA);
+	Queue->Watch(Chunks[1], BatchASecond);
+	Queue->Watch(Chunks[2], BatchB);
+	TestEqual(TEXT("Chunks sharing buffers are one batch"), Queue->GetStats().Outstanding, 2);
+
+	Queue->Poll([](const FPlanetComputeShaderReadback& Readback) { return false; });
+	FChunkReadbackQueue::FCompletion Completion;
+	TestFalse(TEXT("Nothing ready, nothing queued"), Queue->Dequeue(Completion));
+	TestEqual(TEXT("Unready batches stay outstanding"), Queue->GetStats().Outstanding, 2);
+
+	// One check per batch, every chunk of a ready batch is queued
+	int32 NumChecks = 0;
+	Queue->Poll([&NumChecks, &BatchA](const FPlanetComputeShaderReadback& Readback)
+	{
+		NumChecks++;
+		return Readback.OutputBuffer == BatchA.OutputBuffer;
+	});
+	TestEqual(TEXT("Each outstanding batch is checked once"), NumChecks, 2);
+
+	FChunkReadbackQueue::FStats Stats = Queue->GetStats();
+	TestEqual(TEXT("The ready batch is no longer outstanding"), Stats.Outstanding, 1);
+	TestEqual(TEXT("Both chunks of the ready batch are queued"), Stats.Queued, 2);
+
+	TArray<UChunkObject*> Dequeued;
+	while (Queue->Dequeue(Completion))
+	{
+		Dequeued.Add(Completion.Chunk);
+		TestTrue(TEXT("Latency is measured from the watch"), Completion.LatencySeconds >= 0.0);
+	}
+	TestEqual(TEXT("The ready batch's chunks come out in watch order"), Dequeued, TArray<UChunkObject*>({ Chunks[0], Chunks[1] }));
+	TestEqual(TEXT("Nothing queued once drained"), Queue->GetStats().Queued, 0);
+
+	// Buffers handed out again after their batch completed start a new batch
+	Queue->Watch(Chunks[3], BatchA);
+	TestEqual(TEXT("Reused buffers are a new batch"), Queue->GetStats().Outstanding, 2);
+
+	Queue->Poll([](const FPlanetComputeShaderReadback& Readback) { return true; });
+	TestEqual(TEXT("Every ready chunk is queued"), Queue->GetStats().Queued, 2);
+
+	Queue->Reset();
+	Stats = Queue->GetStats();
+	TestEqual(TEXT("Reset forgets the outstanding batches"), Stats.Outstanding, 0);
+	TestEqual(TEXT("Reset forgets the queued chunks"), Stats.Queued, 0);
+	TestFalse(TEXT("Nothing to dequeue after the reset"), Queue->Dequeue(Completion));
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,116 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2026 Maciej Tkaczewski
+
+#include "Misc/AutomationTest.h"
+#include "ChunkScheduler.h"
+#include "ChunkObject.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ChunkSchedulerTest
+{
+	// A PENDING_GENERATION chunk, told apart by the X of its ChunkLocation
+	UChunkObject* MakeChunk(UPlanetData* PlanetData, int32 Id)
+	{
+		UChunkObject* Chunk = NewObject<UChunkObject>(GetTransientPackage(), NAME_None, RF_Transient);
+		Chunk->PlanetData = PlanetData;
+		Chunk->InitializeChunk(16, 1000.0f, 0, FVector(Id, 0.0, 0.0), FVector::ZeroVector, FIntVector(0, 0, 1), 0.0f, 0, nullptr, nullptr);
+		return Chunk;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChunkSchedulerPriorityTest, "PPG.ChunkScheduler.Priority",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FChunkSchedulerPriorityTest::RunTest(const FString& Parameters)
+{
+	// Edge length over the distance to the nearest edge
+	TestEqual(TEXT("Screen-space size"), FChunkScheduler::ComputePriority(1500.0, 1000.0, false, 4.0f), 1.0f, KINDA_SMALL_NUMBER);
+
+	TestTrue(TEXT("Closer chunks first"),
+		FChunkScheduler::ComputePriority(2000.0, 1000.0, false, 4.0f) > FChunkScheduler::ComputePriority(4000.0, 1000.0, false, 4.0f));
+	TestTrue(TEXT("Larger chunks first at the same distance"),
+		FChunkScheduler::ComputePriority(4000.0, 2000.0, false, 4.0f) > FChunkScheduler::ComputePriority(4000.0, 1000.0, false, 4.0f));
+
+	TestEqual(TEXT("Blocking chunks are boosted by BlockingScale"),
+		FChunkScheduler::ComputePriority(3000.0, 1000.0, true, 4.0f), FChunkScheduler::ComputePriority(3000.0, 1000.0, false, 4.0f) * 4.0f, KINDA_SMALL_NUMBER);
+
+	// A view inside the chunk's reach must not divide by zero or go negative
+	TestEqual(TEXT("Distance is clamped at the chunk's edge"), FChunkScheduler::ComputePriority(100.0, 1000.0, false, 4.0f), 1000.0f, KINDA_SMALL_NUMBER);
+	TestEqual(TEXT("Clamped the same at the center"), FChunkScheduler::ComputePriority(0.0, 1000.0, false, 4.0f), 1000.0f, KINDA_SMALL_NUMBER);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChunkSchedulerDispatchTest, "PPG.ChunkScheduler.Dispatch",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FChunkSchedulerDispatchTest::RunTest(const FString& Parameters)
+{
+	using namespace ChunkSchedulerTest;
+
+	UPlanetData* PlanetData = NewObject<UPlanetData>(GetTransientPackage(), NAME_None, RF_Transient);
+
+	// Records the submitted chunks and sends them back to PENDING_GENERATION, out of the pipeline
+	const TSharedRef<FChunkPipeline> Pipeline = MakeShared<FChunkPipeline>();
+	TArray<int32> Submitted;
+	Pipeline->SetBatchDispatcher([&Submitted](TArray<FPlanetComputeShaderDispatchParams> Params, TFunction<void(TArray<FPlanetComputeShaderReadback>)> OnDispatchComplete)
+	{
+		TArray<FPlanetComputeShaderReadback> Readbacks;
+		for (const FPlanetComputeShaderDispatchParams& Chunk : Params)
+		{
+			Submitted.Add(FMath::RoundToInt32(Chunk.ChunkLocation.X));
+			Readbacks.AddDefaulted_GetRef().bRetryDispatch = true;
+		}
+		OnDispatchComplete(MoveTemp(Readbacks));
+	});
+
+	TArray<UChunkObject*> Chunks;
+	for (int32 Id = 0; Id < 6; Id++)
+	{
+		Chunks.Add(MakeChunk(PlanetData, Id));
+	}
+	Chunks[5]->SetAbortAsync();
+
+	FChunkScheduler Scheduler;
+	const auto RequestAll = [&Scheduler, &Chunks]()
+	{
+		// Priority rises with the id
+		for (int32 Id = 0; Id < Chunks.Num(); Id++)
+		{
+			Scheduler.Request(Chunks[Id], static_cast<float>(Id));
+		}
+	};
+
+	// The pipeline's capacity clamps MaxGenerations
+	Pipeline->SetMaxInFlight(2);
+	RequestAll();
+	TestEqual(TEXT("Started up to the pipeline's capacity"), Scheduler.Dispatch(10, *Pipeline), 2);
+	TestEqual(TEXT("Valid requests left over are held, the aborted one is not"), Scheduler.GetNumHeld(), 3);
+	TestEqual(TEXT("The queue is cleared"), Scheduler.Num(), 0);
+
+	Pipeline->FlushDispatches();
+	TestEqual(TEXT("Highest priority first, aborted chunks skipped"), Submitted, TArray<int32>({ 4, 3 }));
+
+	// And MaxGenerations clamps the pipeline's capacity
+	Submitted.Reset();
+	Pipeline->SetMaxInFlight(MAX_int32);
+	RequestAll();
+	TestEqual(TEXT("Started up to MaxGenerations"), Scheduler.Dispatch(1, *Pipeline), 1);
+	TestEqual(TEXT("Held behind MaxGenerations"), Scheduler.GetNumHeld(), 4);
+	Pipeline->FlushDispatches();
+	TestEqual(TEXT("The single start is the top priority"), Submitted, TArray<int32>({ 4 }));
+
+	// No capacity at all holds every valid request
+	Pipeline->SetMaxInFlight(0);
+	RequestAll();
+	TestEqual(TEXT("Nothing started without capacity"), Scheduler.Dispatch(10, *Pipeline), 0);
+	TestEqual(TEXT("Every valid request is held"), Scheduler.GetNumHeld(), 5);
+
+	Scheduler.Reset();
+	TestEqual(TEXT("Reset clears the held count"), Scheduler.GetNumHeld(), 0);
+
+	return true;
+}
+
+#endif
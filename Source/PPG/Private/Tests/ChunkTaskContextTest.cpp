@@ -0,0 +1,134 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2026 Maciej Tkaczewski
+
+#include "Misc/AutomationTest.h"
+#include "ChunkTaskContext.h"
+#include "HAL/Event.h"
+#include <atomic>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ChunkTaskContextTest
+{
+	// Tasks block on the gate until the test opens it, so the queues can be inspected while they run
+	struct FGate
+	{
+		FEvent* Event = FPlatformProcess::GetSynchEventFromPool(true);
+		~FGate() { FPlatformProcess::ReturnSynchEventToPool(Event); }
+	};
+
+	// Order the tasks ran in
+	struct FLog
+	{
+		FCriticalSection CriticalSection;
+		TArray<FString> Entries;
+
+		void Add(const FString& Entry)
+		{
+			FScopeLock Lock(&CriticalSection);
+			Entries.Add(Entry);
+		}
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChunkTaskContextLaneOrderTest, "PPG.ChunkTaskContext.LaneOrder",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FChunkTaskContextLaneOrderTest::RunTest(const FString& Parameters)
+{
+	using namespace ChunkTaskContextTest;
+
+	const TSharedRef<FChunkTaskContext> Context = MakeShared<FChunkTaskContext>();
+	FChunkTaskContext::FSettings Settings;
+	Settings.MaxWorkers = 1;
+	Settings.MaxBackgroundWorkers = 1;
+	Context->Configure(Settings);
+
+	FGate Gate;
+	FLog Log;
+
+	// Holds the only worker while the rest is queued
+	Context->Launch(EChunkTaskLane::Near, [&Gate, &Log]()
+	{
+		Gate.Event->Wait();
+		Log.Add(TEXT("First"));
+	});
+	Context->Launch(EChunkTaskLane::Background, [&Log]() { Log.Add(TEXT("Background 1")); });
+	Context->Launch(EChunkTaskLane::Near, [&Log]() { Log.Add(TEXT("Near 1")); });
+	Context->Launch(EChunkTaskLane::Background, [&Log]() { Log.Add(TEXT("Background 2")); });
+	Context->Launch(EChunkTaskLane::Near, [&Log]() { Log.Add(TEXT("Near 2")); });
+
+	const FChunkTaskContext::FLaneStats Near = Context->GetLaneStats(EChunkTaskLane::Near);
+	const FChunkTaskContext::FLaneStats Background = Context->GetLaneStats(EChunkTaskLane::Background);
+	TestEqual(TEXT("One Near task running"), Near.Running, 1);
+	TestEqual(TEXT("Near tasks queued behind it"), Near.Queued, 2);
+	TestEqual(TEXT("No Background task running"), Background.Running, 0);
+	TestEqual(TEXT("Background tasks queued"), Background.Queued, 2);
+
+	Gate.Event->Trigger();
+	Context->FlushRunningTasks();
+
+	// Queued Near tasks go first whatever order they were launched in, each lane keeps its own order
+	const TArray<FString> Expected = { TEXT("First"), TEXT("Near 1"), TEXT("Near 2"), TEXT("Background 1"), TEXT("Background 2") };
+	TestEqual(TEXT("Run order"), Log.Entries, Expected);
+	TestEqual(TEXT("Nothing left queued"), Context->GetLaneStats(EChunkTaskLane::Background).Queued, 0);
+	TestEqual(TEXT("Nothing left running"), Context->GetLaneStats(EChunkTaskLane::Near).Running, 0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChunkTaskContextBackgroundCapTest, "PPG.ChunkTaskContext.BackgroundCap",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FChunkTaskContextBackgroundCapTest::RunTest(const FString& Parameters)
+{
+	using namespace ChunkTaskContextTest;
+
+	const TSharedRef<FChunkTaskContext> Context = MakeShared<FChunkTaskContext>();
+	FChunkTaskContext::FSettings Settings;
+	Settings.MaxWorkers = 3;
+	Settings.MaxBackgroundWorkers = 1;
+	Context->Configure(Settings);
+
+	FGate Gate;
+	std::atomic<int32> NumRun = 0;
+	const auto Task = [&Gate, &NumRun]()
+	{
+		Gate.Event->Wait();
+		NumRun++;
+	};
+
+	for (int32 Index = 0; Index < 3; Index++)
+	{
+		Context->Launch(EChunkTaskLane::Background, Task);
+	}
+
+	FChunkTaskContext::FLaneStats Background = Context->GetLaneStats(EChunkTaskLane::Background);
+	TestEqual(TEXT("Background runs up to MaxBackgroundWorkers"), Background.Running, 1);
+	TestEqual(TEXT("The rest of Background waits, even with workers free"), Background.Queued, 2);
+
+	// The free workers are Near's
+	Context->Launch(EChunkTaskLane::Near, Task);
+	Context->Launch(EChunkTaskLane::Near, Task);
+	Context->Launch(EChunkTaskLane::Near, Task);
+	const FChunkTaskContext::FLaneStats Near = Context->GetLaneStats(EChunkTaskLane::Near);
+	TestEqual(TEXT("Near takes the workers Background may not"), Near.Running, 2);
+	TestEqual(TEXT("Near waits once MaxWorkers are busy"), Near.Queued, 1);
+
+	// Raising the cap starts queued Background tasks right away, as far as MaxWorkers allows
+	Settings.MaxWorkers = 4;
+	Settings.MaxBackgroundWorkers = 2;
+	Context->Configure(Settings);
+	TestEqual(TEXT("Queued Near tasks take a new worker first"), Context->GetLaneStats(EChunkTaskLane::Near).Running, 3);
+	Background = Context->GetLaneStats(EChunkTaskLane::Background);
+	TestEqual(TEXT("Background still waits while MaxWorkers are busy"), Background.Running, 1);
+
+	Gate.Event->Trigger();
+	Context->FlushRunningTasks();
+	TestEqual(TEXT("Every task ran"), NumRun.load(), 6);
+	TestEqual(TEXT("Nothing left running"), Context->GetLaneStats(EChunkTaskLane::Background).Running, 0);
+
+	return true;
+}
+
+#endif
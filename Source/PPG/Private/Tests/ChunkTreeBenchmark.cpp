@@ -0,0 +1,212 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2026 Maciej Tkaczewski
+
+#include "Misc/AutomationTest.h"
+#include "PlanetSpawner.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ChunkTreeBenchmark
+{
+	// The quadtree layout FChunkTree replaced: one heap allocation per node, children behind shared pointers.
+	// It carries the same hot fields as FChunkTreeNode so only the layout differs.
+	struct FSharedNode
+	{
+		TSharedPtr<FSharedNode> Child1;
+		TSharedPtr<FSharedNode> Child2;
+		TSharedPtr<FSharedNode> Child3;
+		TSharedPtr<FSharedNode> Child4;
+
+		TObjectPtr<UChunkObject> ChunkObject = nullptr;
+		float MaxChunkHeight = 0;
+		int32 PendingFrames = 0;
+
+		FVector WorldCenter = FVector::ZeroVector;
+		double ChunkSize = 0.0;
+	};
+
+	// Faces are unit squares placed side by side, the view sits above face 0
+	const FVector ViewLocation(0.31, 0.62, 0.0);
+
+	// Uniform down to a few levels, then refined around the view like the distance LOD does
+	bool ShouldSplit(const FVector& Center, double ChunkSize, int32 Level, int32 MaxLevel)
+	{
+		return Level < 3 || (Level < MaxLevel && FVector::Dist(Center, ViewLocation) < ChunkSize * 3.0);
+	}
+
+	FVector GetChildCenter(const FVector& ParentCenter, double ChildSize, int32 Child)
+	{
+		const double X = (Child & 1) ? 0.5 : -0.5;
+		const double Y = (Child & 2) ? 0.5 : -0.5;
+		return ParentCenter + FVector(X * ChildSize, Y * ChildSize, 0.0);
+	}
+
+	void BuildPool(FChunkTree& Tree, int32 NodeIndex, int32 MaxLevel)
+	{
+		const FChunkTreeNode Node = Tree.Nodes[NodeIndex];
+		if (!ShouldSplit(Node.WorldCenter, Node.ChunkSize, Node.Level, MaxLevel))
+		{
+			return;
+		}
+
+		// Blocks of four siblings, as FChunkTree::AllocateChildren lays them out
+		const int32 FirstChild = Tree.Nodes.AddDefaulted(4);
+		Tree.ChunkObjects.AddDefaulted(4);
+		Tree.Nodes[NodeIndex].FirstChild = FirstChild;
+		for (int32 i = 0; i < 4; i++)
+		{
+			FChunkTreeNode& Child = Tree.Nodes[FirstChild + i];
+			Child.ChunkSize = Node.ChunkSize / 2;
+			Child.WorldCenter = GetChildCenter(Node.WorldCenter, Child.ChunkSize, i);
+			Child.Level = Node.Level + 1;
+			Child.Parent = NodeIndex;
+		}
+
+		for (int32 i = 0; i < 4; i++)
+		{
+			BuildPool(Tree, FirstChild + i, MaxLevel);
+		}
+	}
+
+	// With Interleaved, unrelated allocations are made between the nodes, as the old tree was built over many frames
+	// between chunk objects and their arrays. Without it the nodes end up next to each other, the best case for this layout.
+	void BuildShared(FSharedNode& Node, int32 Level, int32 MaxLevel, TArray<TArray<uint8>>* Interleaved, FRandomStream& Random)
+	{
+		if (!ShouldSplit(Node.WorldCenter, Node.ChunkSize, Level, MaxLevel))
+		{
+			return;
+		}
+
+		TSharedPtr<FSharedNode>* Children[4] = { &Node.Child1, &Node.Child2, &Node.Child3, &Node.Child4 };
+		for (int32 i = 0; i < 4; i++)
+		{
+			if (Interleaved != nullptr)
+			{
+				Interleaved->AddDefaulted_GetRef().SetNumUninitialized(Random.RandRange(64, 4096));
+			}
+			*Children[i] = MakeShared<FSharedNode>();
+			(*Children[i])->ChunkSize = Node.ChunkSize / 2;
+			(*Children[i])->WorldCenter = GetChildCenter(Node.WorldCenter, (*Children[i])->ChunkSize, i);
+			BuildShared(**Children[i], Level + 1, MaxLevel, Interleaved, Random);
+		}
+	}
+
+	// Full traversal reading what the LOD evaluation reads, returns the nodes that would split
+	int32 TraversePool(const FChunkTree& Tree, int32 NodeIndex)
+	{
+		const FChunkTreeNode& Node = Tree.Nodes[NodeIndex];
+		int32 NumSplit = FVector::DistSquared(Node.WorldCenter, ViewLocation) < FMath::Square(Node.ChunkSize * 3.0) ? 1 : 0;
+		if (Node.FirstChild != INDEX_NONE)
+		{
+			for (int32 i = 0; i < 4; i++)
+			{
+				NumSplit += TraversePool(Tree, Node.FirstChild + i);
+			}
+		}
+		return NumSplit;
+	}
+
+	int32 TraverseShared(const FSharedNode& Node)
+	{
+		int32 NumSplit = FVector::DistSquared(Node.WorldCenter, ViewLocation) < FMath::Square(Node.ChunkSize * 3.0) ? 1 : 0;
+		if (Node.Child1.IsValid())
+		{
+			NumSplit += TraverseShared(*Node.Child1);
+			NumSplit += TraverseShared(*Node.Child2);
+			NumSplit += TraverseShared(*Node.Child3);
+			NumSplit += TraverseShared(*Node.Child4);
+		}
+		return NumSplit;
+	}
+
+	// Fastest of Iterations runs, in microseconds
+	template<typename LambdaType>
+	double TimeTraversal(int32 Iterations, LambdaType&& Traverse, int32& OutNumSplit)
+	{
+		double Best = MAX_dbl;
+		for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+		{
+			const double StartTime = FPlatformTime::Seconds();
+			OutNumSplit = Traverse();
+			Best = FMath::Min(Best, FPlatformTime::Seconds() - StartTime);
+		}
+		return Best * 1000000.0;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChunkTreeTraversalBenchmark, "PPG.ChunkTree.TraversalBenchmark",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+bool FChunkTreeTraversalBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace ChunkTreeBenchmark;
+
+	constexpr int32 Iterations = 200;
+
+	for (const int32 MaxLevel : { 10, 12, 14 })
+	{
+		FChunkTree Pool;
+		Pool.Nodes.SetNum(FChunkTree::NumFaces);
+		Pool.ChunkObjects.SetNum(FChunkTree::NumFaces);
+
+		TArray<TSharedPtr<FSharedNode>> SharedRoots;
+		TArray<TSharedPtr<FSharedNode>> ScatteredRoots;
+		TArray<TArray<uint8>> Interleaved;
+		FRandomStream Random(MaxLevel);
+		for (int32 Face = 0; Face < FChunkTree::NumFaces; Face++)
+		{
+			const FVector FaceCenter(0.5 + Face * 2.0, 0.5, 0.0);
+			Pool.Nodes[Face].WorldCenter = FaceCenter;
+			Pool.Nodes[Face].ChunkSize = 1.0;
+			BuildPool(Pool, Face, MaxLevel);
+
+			TSharedPtr<FSharedNode>& Root = SharedRoots.Add_GetRef(MakeShared<FSharedNode>());
+			Root->WorldCenter = FaceCenter;
+			Root->ChunkSize = 1.0;
+			BuildShared(*Root, 0, MaxLevel, nullptr, Random);
+
+			TSharedPtr<FSharedNode>& ScatteredRoot = ScatteredRoots.Add_GetRef(MakeShared<FSharedNode>());
+			ScatteredRoot->WorldCenter = FaceCenter;
+			ScatteredRoot->ChunkSize = 1.0;
+			BuildShared(*ScatteredRoot, 0, MaxLevel, &Interleaved, Random);
+		}
+
+		int32 PoolSplit = 0;
+		const double PoolMicroseconds = TimeTraversal(Iterations, [&Pool]()
+		{
+			int32 NumSplit = 0;
+			for (int32 Face = 0; Face < FChunkTree::NumFaces; Face++)
+			{
+				NumSplit += TraversePool(Pool, Face);
+			}
+			return NumSplit;
+		}, PoolSplit);
+
+		const auto TraverseRoots = [](const TArray<TSharedPtr<FSharedNode>>& Roots)
+		{
+			int32 NumSplit = 0;
+			for (const TSharedPtr<FSharedNode>& Root : Roots)
+			{
+				NumSplit += TraverseShared(*Root);
+			}
+			return NumSplit;
+		};
+
+		int32 SharedSplit = 0;
+		const double SharedMicroseconds = TimeTraversal(Iterations, [&]() { return TraverseRoots(SharedRoots); }, SharedSplit);
+
+		int32 ScatteredSplit = 0;
+		const double ScatteredMicroseconds = TimeTraversal(Iterations, [&]() { return TraverseRoots(ScatteredRoots); }, ScatteredSplit);
+
+		TestEqual(FString::Printf(TEXT("Both layouts hold the same tree at level %d"), MaxLevel), PoolSplit, SharedSplit);
+		TestEqual(FString::Printf(TEXT("Both layouts hold the same tree at level %d"), MaxLevel), PoolSplit, ScatteredSplit);
+
+		const double PoolTime = FMath::Max(PoolMicroseconds, UE_DOUBLE_SMALL_NUMBER);
+		AddInfo(FString::Printf(TEXT("MaxRecursionLevel %d, %d nodes: node pool %.1f us, shared pointers %.1f us (%.2fx), scattered shared pointers %.1f us (%.2fx)"),
+			MaxLevel, Pool.Nodes.Num(), PoolMicroseconds, SharedMicroseconds, SharedMicroseconds / PoolTime, ScatteredMicroseconds, ScatteredMicroseconds / PoolTime));
+	}
+
+	return true;
+}
+
+#endif
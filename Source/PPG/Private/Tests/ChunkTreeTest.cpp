@@ -0,0 +1,118 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2026 Maciej Tkaczewski
+
+#include "Misc/AutomationTest.h"
+#include "PlanetSpawner.h"
+#include "ChunkObject.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ChunkTreeTest
+{
+	using EChunkStatus = UChunkObject::EChunkStatus;
+
+	// Children of NodeIndex, laid out as FChunkTree::AllocateChildren does but without placing them on the planet
+	int32 AddChildren(FChunkTree& Tree, int32 NodeIndex)
+	{
+		const int32 FirstChild = Tree.Nodes.AddDefaulted(4);
+		Tree.ChunkObjects.AddDefaulted(4);
+		for (int32 i = 0; i < 4; i++)
+		{
+			Tree.Nodes[FirstChild + i].Parent = NodeIndex;
+			Tree.Nodes[FirstChild + i].Level = Tree.Nodes[NodeIndex].Level + 1;
+		}
+		Tree.Nodes[NodeIndex].FirstChild = FirstChild;
+		return FirstChild;
+	}
+
+	UChunkObject* Attach(FChunkTree& Tree, int32 NodeIndex, EChunkStatus Status = EChunkStatus::PENDING_GENERATION)
+	{
+		UChunkObject* Chunk = NewObject<UChunkObject>(GetTransientPackage(), NAME_None, RF_Transient);
+		Chunk->SetChunkStatus(Status);
+		Tree.AttachChunk(NodeIndex, Chunk);
+		return Chunk;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChunkTreeCountersTest, "PPG.ChunkTree.Counters",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FChunkTreeCountersTest::RunTest(const FString& Parameters)
+{
+	using namespace ChunkTreeTest;
+
+	UPlanetData* PlanetData = NewObject<UPlanetData>(GetTransientPackage(), NAME_None, RF_Transient);
+	FChunkTree Tree;
+	Tree.Initialize(*PlanetData);
+
+	constexpr int32 Root = 0;
+	const auto TestRoot = [this, &Tree](const TCHAR* What, int32 Chunks, int32 Ready, int32 InFlight, int32 UnreadyFrontier)
+	{
+		const FChunkTreeNode& Node = Tree.Nodes[Root];
+		TestEqual(FString::Printf(TEXT("%s: NumChunks"), What), Node.NumChunks, Chunks);
+		TestEqual(FString::Printf(TEXT("%s: NumReadyChunks"), What), Node.NumReadyChunks, Ready);
+		TestEqual(FString::Printf(TEXT("%s: NumInFlightChunks"), What), Node.NumInFlightChunks, InFlight);
+		TestEqual(FString::Printf(TEXT("%s: NumUnreadyFrontier"), What), Node.NumUnreadyFrontier, UnreadyFrontier);
+	};
+
+	UChunkObject* RootChunk = Attach(Tree, Root);
+	TestRoot(TEXT("Root attached"), 1, 0, 0, 1);
+	RootChunk->SetChunkStatus(EChunkStatus::GENERATING);
+	TestRoot(TEXT("Root generating"), 1, 0, 1, 1);
+	RootChunk->SetChunkStatus(EChunkStatus::READY);
+	TestRoot(TEXT("Root ready"), 1, 1, 0, 0);
+
+	// Split: the children generate under the READY root, which hides them from the frontier
+	const int32 FirstChild = AddChildren(Tree, Root);
+	UChunkObject* Children[4];
+	for (int32 i = 0; i < 4; i++)
+	{
+		Children[i] = Attach(Tree, FirstChild + i, EChunkStatus::GENERATING);
+	}
+	TestRoot(TEXT("Children generating"), 5, 1, 4, 0);
+	TestEqual(TEXT("A child's own chunk is its frontier"), Tree.Nodes[FirstChild].NumUnreadyFrontier, 1);
+
+	for (int32 i = 0; i < 3; i++)
+	{
+		Children[i]->SetChunkStatus(EChunkStatus::READY);
+	}
+	TestRoot(TEXT("Three children ready"), 5, 4, 1, 0);
+
+	// Once the root's chunk is gone the children are the frontier
+	Tree.DetachChunk(Root);
+	TestRoot(TEXT("Root detached"), 4, 3, 1, 1);
+	Children[3]->SetChunkStatus(EChunkStatus::READY);
+	TestRoot(TEXT("Split done"), 4, 4, 0, 0);
+	TestEqual(TEXT("Planet counters sum the faces"), Tree.GetNumReadyChunks(), 4);
+
+	// Merge: the new root chunk hides the READY children until it is ready itself
+	RootChunk = Attach(Tree, Root, EChunkStatus::GENERATING);
+	TestRoot(TEXT("Merge generating"), 5, 4, 1, 1);
+	RootChunk->SetChunkStatus(EChunkStatus::READY);
+	TestRoot(TEXT("Merge ready"), 5, 5, 0, 0);
+	for (int32 i = 0; i < 4; i++)
+	{
+		Tree.DetachChunk(FirstChild + i);
+	}
+	TestRoot(TEXT("Merge done"), 1, 1, 0, 0);
+	TestEqual(TEXT("Detached children leave no frontier behind"), Tree.Nodes[FirstChild].NumUnreadyFrontier, 0);
+
+	// Abort: a chunk that leaves the pipeline without becoming READY is still unready
+	Tree.DetachChunk(Root);
+	UChunkObject* Aborted = Attach(Tree, FirstChild + 2, EChunkStatus::GENERATING);
+	TestRoot(TEXT("Child generating alone"), 1, 0, 1, 1);
+	Aborted->SetChunkStatus(EChunkStatus::ABORTED);
+	TestRoot(TEXT("Child aborted"), 1, 0, 0, 1);
+	Tree.DetachChunk(FirstChild + 2);
+	TestRoot(TEXT("Aborted child destroyed"), 0, 0, 0, 0);
+	TestEqual(TEXT("Planet is empty"), Tree.GetNumChunks(), 0);
+
+	// Detached chunks no longer report to the tree
+	Aborted->SetChunkStatus(EChunkStatus::READY);
+	TestRoot(TEXT("Detached chunk changed status"), 0, 0, 0, 0);
+
+	Tree.Reset();
+	return true;
+}
+
+#endif
@@ -0,0 +1,147 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2026 Maciej Tkaczewski
+
+#include "Misc/AutomationTest.h"
+#include "PlanetQualityGovernor.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace PlanetQualityGovernorTest
+{
+	constexpr float DeltaTime = 0.1f;
+
+	// No smoothing, and a frame rate target the frame time never comes close to, so the backlogs alone set the pressure
+	FPlanetQualityGovernorSettings MakeSettings()
+	{
+		FPlanetQualityGovernorSettings Settings;
+		Settings.bEnabled = true;
+		Settings.TargetFrameRate = 1.0f;
+		Settings.MaxChunkBacklog = 10;
+		Settings.MaxFinalizeBacklog = 10;
+		Settings.SmoothingTime = 0.0f;
+		Settings.Headroom = 0.8f;
+		Settings.DecreaseRate = 1.0f;
+		Settings.IncreaseRate = 1.0f;
+		Settings.BiasStep = 0.125f;
+		Settings.MinLODBias = -2.0f;
+		Settings.MaxLODBias = 1.0f;
+		return Settings;
+	}
+
+	// Pressure relative to MaxChunkBacklog and MaxFinalizeBacklog of MakeSettings
+	FPlanetQualityGovernor::FSample MakeSample(int32 Backlog, int32 FinalizeBacklog = 0)
+	{
+		FPlanetQualityGovernor::FSample Sample;
+		Sample.DeltaTime = DeltaTime;
+		Sample.Backlog = Backlog;
+		Sample.FinalizeBacklog = FinalizeBacklog;
+		return Sample;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlanetQualityGovernorBiasTest, "PPG.QualityGovernor.Bias",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FPlanetQualityGovernorBiasTest::RunTest(const FString& Parameters)
+{
+	using namespace PlanetQualityGovernorTest;
+
+	const FPlanetQualityGovernorSettings Settings = MakeSettings();
+	FPlanetQualityGovernor Governor;
+
+	// Finalization falling behind lowers the detail, in steps of BiasStep
+	TestFalse(TEXT("Less than a step is not applied"), Governor.Update(Settings, MakeSample(0, 20)));
+	TestEqual(TEXT("Pressure of the finalize backlog"), Governor.GetPressure(), 2.0f, KINDA_SMALL_NUMBER);
+	TestEqual(TEXT("Bias not applied yet"), Governor.GetLODBias(), 0.0f);
+
+	TestTrue(TEXT("A full step is applied"), Governor.Update(Settings, MakeSample(0, 20)));
+	TestEqual(TEXT("Bias lowered at DecreaseRate"), Governor.GetLODBias(), -0.2f, KINDA_SMALL_NUMBER);
+	TestEqual(TEXT("Split distances scale by 2^bias"), Governor.GetLODDistanceScale(), FMath::Exp2(-0.2f), KINDA_SMALL_NUMBER);
+	TestEqual(TEXT("Foliage thins out below a bias of 0"), Governor.GetFoliageDensityScale(Settings), FMath::Lerp(0.25f, 1.0f, 0.9f), KINDA_SMALL_NUMBER);
+
+	// So does the generation backlog
+	Governor.Reset();
+	Governor.Update(Settings, MakeSample(20));
+	TestTrue(TEXT("Generation backlog lowers the detail"), Governor.Update(Settings, MakeSample(20)));
+	TestTrue(TEXT("Bias below 0"), Governor.GetLODBias() < 0.0f);
+
+	// A finalize backlog under its limit is no reason to lower the detail, however much of the budget was spent
+	Governor.Reset();
+	for (int32 Frame = 0; Frame < 10; Frame++)
+	{
+		Governor.Update(Settings, MakeSample(0, 5));
+	}
+	TestTrue(TEXT("Busy finalization under the backlog limit does not lower the bias"), Governor.GetLODBias() >= 0.0f);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlanetQualityGovernorHysteresisTest, "PPG.QualityGovernor.Hysteresis",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FPlanetQualityGovernorHysteresisTest::RunTest(const FString& Parameters)
+{
+	using namespace PlanetQualityGovernorTest;
+
+	FPlanetQualityGovernorSettings Settings = MakeSettings();
+	FPlanetQualityGovernor Governor;
+
+	// Between the headroom and the target the bias holds
+	for (int32 Frame = 0; Frame < 20; Frame++)
+	{
+		TestFalse(TEXT("Nothing applied between the headroom and the target"), Governor.Update(Settings, MakeSample(9)));
+	}
+	TestEqual(TEXT("Bias holds between the headroom and the target"), Governor.GetLODBias(), 0.0f);
+
+	// Below the headroom it rises
+	Governor.Update(Settings, MakeSample(5));
+	TestTrue(TEXT("Bias rises below the headroom"), Governor.Update(Settings, MakeSample(5)));
+	TestEqual(TEXT("Bias raised at IncreaseRate"), Governor.GetLODBias(), 0.2f, KINDA_SMALL_NUMBER);
+
+	// Smoothing keeps a single hitch from lowering the detail
+	Settings.SmoothingTime = 1.0f;
+	Governor.Reset();
+	Governor.Update(Settings, MakeSample(9));
+	Governor.Update(Settings, MakeSample(15));
+	TestTrue(TEXT("A single hitch stays under the target"), Governor.GetPressure() > 0.9f && Governor.GetPressure() < 1.0f);
+	TestEqual(TEXT("A single hitch keeps the bias"), Governor.GetLODBias(), 0.0f);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlanetQualityGovernorBoundsTest, "PPG.QualityGovernor.Bounds",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FPlanetQualityGovernorBoundsTest::RunTest(const FString& Parameters)
+{
+	using namespace PlanetQualityGovernorTest;
+
+	FPlanetQualityGovernorSettings Settings = MakeSettings();
+	Settings.MinLODBias = -0.25f;
+	Settings.MaxLODBias = 0.3f;
+	FPlanetQualityGovernor Governor;
+
+	Governor.Update(Settings, MakeSample(20));
+	TestTrue(TEXT("First step down"), Governor.Update(Settings, MakeSample(20)));
+	TestEqual(TEXT("First step down applied"), Governor.GetLODBias(), -0.2f, KINDA_SMALL_NUMBER);
+
+	// Less than a step away, but the bound is reached
+	TestTrue(TEXT("Reaching MinLODBias is applied"), Governor.Update(Settings, MakeSample(20)));
+	TestEqual(TEXT("Snapped to MinLODBias"), Governor.GetLODBias(), -0.25f);
+	TestFalse(TEXT("Staying at the bound changes nothing"), Governor.Update(Settings, MakeSample(20)));
+
+	// Up to the other bound
+	int32 Frames = 0;
+	while (Governor.GetLODBias() < Settings.MaxLODBias && Frames < 100)
+	{
+		Governor.Update(Settings, MakeSample(0));
+		Frames++;
+	}
+	TestEqual(TEXT("Snapped to MaxLODBias"), Governor.GetLODBias(), 0.3f);
+	TestFalse(TEXT("Staying at the upper bound changes nothing"), Governor.Update(Settings, MakeSample(0)));
+	TestEqual(TEXT("No foliage thinning above a bias of 0"), Governor.GetFoliageDensityScale(Settings), Settings.MaxFoliageDensityScale);
+
+	return true;
+}
+
+#endif
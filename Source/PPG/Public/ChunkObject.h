@@ -9,11 +9,52 @@
 #include "PlanetData.h"
 #include "FoliageData.h"
 #include "PlanetNaniteBuilder.h"
+#include "ChunkScheduler.h"
 #include "Rendering/NaniteResources.h"
+#include "StaticMeshResources.h"
 #include "Chaos/TriangleMeshImplicitObject.h"
 #include "ComputeShader/Public/PlanetComputeShader/PlanetComputeShader.h"
 #include "ChunkObject.generated.h"
 
+struct FChunkTree;
+
+/**
+ * Game-thread time budget shared by the finalization of every chunk in a frame (mesh creation, components, foliage, water).
+ * Finalization runs in short steps and a step only starts while time is left, so each frame still makes some progress.
+ * Process-wide on purpose: the budget bounds the frame's hitch, and every planet of every world finalizes on the same game thread.
+ * A per-planet budget would let N planets spend N times the frame time.
+ */
+struct PPG_API FChunkFinalizeBudget
+{
+	// Start the budget for the current frame. Several planets in one frame share it, the largest budget wins.
+	static void BeginFrame(float BudgetMs);
+
+	static bool HasTime() { return SpentSeconds < BudgetSeconds; }
+	static void Spend(double Seconds) { SpentSeconds += Seconds; }
+
+	static double GetSpentMs() { return SpentSeconds * 1000.0; }
+
+private:
+	inline static uint64 Frame = MAX_uint64;
+	inline static double BudgetSeconds = 0.0;
+	inline static double SpentSeconds = 0.0;
+};
+
+/**
+ * Thread-safe cancellation flag shared by every stage working on one chunk.
+ * Worker loops poll it, so a cancelled chunk stops using worker time within one loop iteration instead of at the next stage boundary.
+ */
+struct FChunkCancellationToken
+{
+	void Cancel() { bCancelled.Set(true, std::memory_order_relaxed); }
+	bool IsCancelled() const { return bCancelled.Get(std::memory_order_relaxed); }
+
+	// For builders outside the chunk pipeline that take a plain flag
+	const TVoxelAtomic<bool>& GetFlag() const { return bCancelled; }
+
+private:
+	TVoxelAtomic<bool> bCancelled = false;
+};
 
 /**
  * 
@@ -54,8 +95,20 @@ public:
 		ABORTED = 6,
 	};
 	
+	// Written through SetChunkStatus so the owning quadtree can keep its counters up to date
 	EChunkStatus ChunkStatus = EChunkStatus::PENDING_GENERATION;
 
+	void SetChunkStatus(EChunkStatus NewStatus);
+
+	// Chunk has started work that has not reached READY yet
+	static bool IsInFlight(EChunkStatus Status)
+	{
+		return Status == EChunkStatus::GENERATING || Status == EChunkStatus::WAITING_FOR_GPU || Status == EChunkStatus::PENDING_ASSIGN;
+	}
+
+	// Set by FChunkTree while the chunk is attached to one of its nodes
+	void SetTreeNode(FChunkTree* InTree, int32 InNodeIndex) { OwningTree = InTree; TreeNodeIndex = InNodeIndex; }
+
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Chunk|Setup")
 	bool bNaniteLandscape = true;
 
@@ -87,22 +140,40 @@ public:
 	void GenerateChunk();
 
 	UFUNCTION(BlueprintCallable, Category = "Chunk|Generation")
-	void CompleteChunkGeneration();
+	void AddWaterChunk();
 
 	UFUNCTION(BlueprintCallable, Category = "Chunk|Generation")
-	void UploadChunk();
+	void GenerationComplete();
 
-	UFUNCTION(BlueprintCallable, Category = "Chunk|Generation")
-	void UploadFoliageData();
+	// Stages driven by FChunkPipeline
+	// GenerateChunk without the dispatch: the pipeline dispatches the chunks of a frame in batches
+	void PrepareDispatch(FPlanetComputeShaderDispatchParams& Params);
+	void OnDispatchComplete(const FPlanetComputeShaderReadback& Readback);
+	bool IsReadbackReady() const;
+	void ReleaseReadback();
+	// Map the readback buffers on the render thread for the surface stage to read in place, OnComplete is called there
+	void StartReadback(TFunction<void(bool bSuccess)> OnComplete);
+	// Worker stages, false if the chunk was cancelled or has no usable data
+	bool RunPipelineStage(EChunkPipelineStage Stage);
 
-	UFUNCTION(BlueprintCallable, Category = "Chunk|Generation")
-	void AddWaterChunk();
+	// Set on chunks prefetched ahead of their node splitting, the assign stage leaves them alone until the node splits
+	bool bAssignHeld = false;
+	void ReleaseAssign() { bAssignHeld = false; }
 
-	UFUNCTION(BlueprintCallable, Category = "Chunk|Generation")
-	void GenerationComplete();
+	// Quick low resolution chunk without foliage or collision, replaced in place by a full quality one later
+	bool bPreview = false;
+
+	// Decided by the tree when the chunk becomes READY: still shown at reduced quality until a full quality chunk replaces it.
+	// Previews, and flat quality chunks whose own surface turned out not to be flat.
+	bool bNeedsRefinement = false;
+
+	// Layout the generated vertices are read back in
+	EPlanetReadbackFormat ReadbackFormat = EPlanetReadbackFormat::Float;
 
-	void TickGPUReadback();
+	// For the full quality chunk replacing a preview: the preview's components are freed in the same step this chunk's are registered
+	void SetReplacedChunk(UChunkObject* InReplacedChunk) { ReplacedChunk = InReplacedChunk; }
 
+	// Run finalization steps while FChunkFinalizeBudget has time left, the chunk is READY once the last one has run
 	UFUNCTION(BlueprintCallable, Category = "Chunk|Generation")
 	void AssignComponents();
 
@@ -121,13 +192,55 @@ public:
 	void SetSharedResources(TArray<TObjectPtr<UStaticMeshComponent>>* InChunkSMCPool, TArray<TObjectPtr<UInstancedStaticMeshComponent>>* InFoliageISMCPool, TArray<TObjectPtr<UStaticMeshComponent>>* InWaterSMCPool, TArray<uint32>* InTriangles);
 	void InitializeChunk(int InChunkQuality, float InChunkWorldSize, int32 InRecursionLevel, FVector InChunkLocation, FVector InPlanetSpaceLocation, FIntVector InPlanetSpaceRotation, float InChunkMaxHeight, uint8 InMaterialLayersNum, UStaticMesh* InCloseWaterMesh, UStaticMesh* InFarWaterMesh);
 
-	void SetAbortAsync(bool bInAbortAsync) { bAbortAsync = bInAbortAsync; }
-	bool GetAbortAsync() const { return bAbortAsync; }
+	// Cancellation is one-way, a cancelled chunk is only ever destroyed
+	void SetAbortAsync() { CancellationToken->Cancel(); }
+	bool GetAbortAsync() const { return CancellationToken->IsCancelled(); }
+	const TSharedRef<FChunkCancellationToken>& GetCancellationToken() const { return CancellationToken; }
 	float GetChunkMaxHeight() const { return ChunkMaxHeight; }
+	int32 GetChunkQuality() const { return ChunkQuality; }
+	float GetHeightDeviation() const { return HeightDeviation; }
+	float GetMaxCurvature() const { return MaxCurvature; }
 
 protected:
-	void ProcessChunkData(const TArray<float>& OutputVal, const TArray<uint8>& OutputVCVal);
-	void SpawnFoliageComponent(FFoliageRuntimeData& Data);
+	bool ProcessSurface();
+	bool PlaceFoliage();
+	bool CookCollision();
+	bool BuildRenderData();
+
+	// Set by the readback stage, read in place and released by the surface stage
+	TSharedPtr<FPlanetComputeShaderMappedReadback> MappedReadback;
+	// Compact formats only: the readback expanded to the Float layout by the surface stage
+	TArray<float> ReadbackPositions;
+	TArray<uint8> ReadbackColors;
+	// Grid the compact formats are decoded on, as the shader saw it
+	FPlanetComputeShaderChunkDesc DispatchChunkDesc;
+
+	// Add up to MaxInstances of Data's instances, creating its component first. Returns true once all are added.
+	bool SpawnFoliageComponent(FFoliageRuntimeData& Data, int32 MaxInstances = MAX_int32);
+
+	// Game-thread finalization after PENDING_ASSIGN, one step per call to RunFinalizeStep
+	enum class EFinalizeStep : uint8
+	{
+		CreateMesh,
+		SetupMaterial,
+		SpawnFoliage,
+		AddWater,
+		Register,
+	};
+
+	// Returns false if the step has to wait for the render thread
+	bool RunFinalizeStep();
+
+	// Foliage instances added per finalization step, large foliage uploads continue on the next step
+	static constexpr int32 FoliageInstancesPerStep = 4096;
+
+	EFinalizeStep FinalizeStep = EFinalizeStep::CreateMesh;
+	int32 FinalizeFoliageIndex = 0;
+	int32 FinalizeFoliageInstance = 0;
+
+	// Produced by the collision and render data stages, turned into ChunkStaticMesh by the CreateMesh step
+	TUniquePtr<FStaticMeshRenderData> PendingRenderData;
+	Chaos::FTriangleMeshImplicitObjectPtr PendingCollisionData;
 
 	UPROPERTY()
 	int32 SpawnAtOnce = 10;
@@ -140,6 +253,14 @@ protected:
 
 	UPROPERTY()
 	float ChunkMaxHeight = 0.0f;
+
+	// Roughness of the generated surface, negative until the surface stage ran.
+	// Standard deviation of the vertex heights, and the largest second derivative of the height along the grid (1/cm).
+	UPROPERTY()
+	float HeightDeviation = -1.0f;
+
+	UPROPERTY()
+	float MaxCurvature = -1.0f;
 	
 	UPROPERTY()
 	float ChunkSize = 200.0f;
@@ -162,8 +283,8 @@ protected:
 	UPROPERTY()
 	bool bDataGenerated = false;
 
-	UPROPERTY()
-	bool bAbortAsync = false;
+	// Shared with in-flight work so it can still see the cancellation after this chunk is gone
+	TSharedRef<FChunkCancellationToken> CancellationToken = MakeShared<FChunkCancellationToken>();
 
 	UPROPERTY()
 	uint8 MaterialLayersNum = 0;
@@ -186,8 +307,13 @@ protected:
 	
 	TArray<uint32>* Triangles;
 
+	FChunkTree* OwningTree = nullptr;
+	int32 TreeNodeIndex = INDEX_NONE;
+
 	FPlanetComputeShaderReadback GPUReadback;
 
+	TWeakObjectPtr<UChunkObject> ReplacedChunk;
+
 private:
 	UPROPERTY()
 	TArray<FVector3f> Vertices;
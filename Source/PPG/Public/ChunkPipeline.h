@@ -0,0 +1,214 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2026 Maciej Tkaczewski
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ChunkTaskContext.h"
+#include "ChunkReadbackQueue.h"
+#include "ComputeShader/Public/PlanetComputeShader/PlanetComputeShader.h"
+
+class UChunkObject;
+
+// Stages a chunk moves through between leaving PENDING_GENERATION and becoming READY.
+// Foliage, Collision and RenderData run side by side once Surface is done, everything else in order.
+enum class EChunkPipelineStage : uint8
+{
+	// Compute dispatch, until the readback buffers are ready
+	Dispatch,
+	// Mapping of the readback buffers on the render thread, Surface reads them in place
+	Readback,
+	// Vertices, normals and slopes on a worker
+	Surface,
+	// Foliage placement on a worker, in parallel with Collision and RenderData
+	Foliage,
+	// Chaos collision cook on a worker
+	Collision,
+	// Nanite render data build on a worker
+	RenderData,
+	// Components, foliage and water on the game thread, within FChunkFinalizeBudget
+	Assign,
+	Num
+};
+
+const TCHAR* LexToString(EChunkPipelineStage Stage);
+
+/**
+ * Moves generating chunks through the stages of EChunkPipelineStage.
+ * Each stage has a bounded queue and a concurrency limit. A stage only starts a chunk while the next stage's queue has room for it,
+ * so a slow stage holds back the ones before it down to the dispatch instead of piling up work.
+ * Chunks are pushed to the next stage as soon as a stage finishes them, worker stages are launched right away from the finishing thread.
+ * Worker stages run in the pipeline's FChunkTaskContext, in the lane the chunk was dispatched with, and queued Near chunks go first.
+ * GPU readiness is polled once per batch by the FChunkReadbackQueue, Tick moves the ready chunks on and runs the game-thread assign.
+ * Dispatched chunks are collected until FlushDispatches and sent to the GPU in batches, one compute dispatch and one readback per batch.
+ * The stages after Surface only read the surface and each fill their own part of the chunk, so they run as parallel branches
+ * joined before the assign stage: a chunk's time from readback to PENDING_ASSIGN is its slowest branch instead of their sum.
+ */
+class PPG_API FChunkPipeline : public TSharedFromThis<FChunkPipeline>
+{
+public:
+	struct FStageSettings
+	{
+		// Chunks worked on at the same time
+		int32 MaxConcurrency = MAX_int32;
+		// Chunks waiting for this stage, the previous stage stops starting new work when it is full
+		int32 QueueCapacity = MAX_int32;
+	};
+
+	struct FStageStats
+	{
+		int32 Queued = 0;
+		int32 Active = 0;
+		// Time from entering the stage's queue to leaving the stage, averaged over the last stats window
+		double AverageLatencyMs = 0.0;
+		// Chunks leaving the stage per second over the last stats window
+		double Throughput = 0.0;
+	};
+
+	void Configure(EChunkPipelineStage Stage, const FStageSettings& Settings);
+
+	// Upper bound on the chunks between the dispatch and the assign stage, bounds render target and readback memory
+	void SetMaxInFlight(int32 InMaxInFlight);
+
+	// Chunks sent to the GPU in one compute dispatch at most, 1 dispatches every chunk on its own. Game thread.
+	void SetMaxBatchSize(int32 InMaxBatchSize);
+
+	// Submits one batch and calls back with a readback per chunk, as FPlanetComputeShaderInterface::DispatchBatch does
+	using FBatchDispatcher = TFunction<void(TArray<FPlanetComputeShaderDispatchParams> Params, TFunction<void(TArray<FPlanetComputeShaderReadback> Readbacks)> OnDispatchComplete)>;
+
+	// Replace how FlushDispatches submits its batches, FPlanetComputeShaderInterface::DispatchBatch by default. Game thread.
+	void SetBatchDispatcher(FBatchDispatcher InBatchDispatcher);
+
+	// Chunks that can be dispatched right now without overflowing the readback queue or the in-flight limit
+	int32 GetDispatchCapacity() const;
+
+	// Start GPU generation of a PENDING_GENERATION chunk, its worker stages run in Lane.
+	// The GPU work is submitted by the next FlushDispatches, batched with the chunks dispatched before it.
+	void Dispatch(UChunkObject* Chunk, EChunkTaskLane Lane);
+
+	// Game thread: submit the chunks dispatched since the last flush in as few batches as possible. Tick flushes first thing.
+	void FlushDispatches();
+
+	// Game thread, once per frame: hand finished GPU work to the readback stage, start readback copies
+	// and finalize chunks in the assign stage while the frame's finalization budget lasts
+	void Tick();
+
+	// Game thread: drop all queued chunks and wait for the running worker stages, cancel the chunks first so they stop early.
+	// Flush the render thread before, so no readback stage is running either. Once this returns the chunks can be destroyed.
+	void Reset();
+
+	FStageStats GetStageStats(EChunkPipelineStage Stage) const;
+
+	// Chunks anywhere between the dispatch and the assign stage
+	int32 GetNumInFlight() const;
+
+	// Runs the worker stages
+	FChunkTaskContext& GetTaskContext() const { return *TaskContext; }
+
+	// Tracks the dispatched chunks until their readbacks are ready
+	const FChunkReadbackQueue& GetReadbackQueue() const { return *ReadbackQueue; }
+
+	// Report every chunk in the pipeline, from the owner's AddReferencedObjects. Keeps them alive while stages use them.
+	void AddReferencedObjects(FReferenceCollector& Collector);
+
+private:
+	struct FEntry
+	{
+		// Resolved on the game thread when the chunk was dispatched, InFlightChunks keeps it alive until it leaves the pipeline
+		UChunkObject* Chunk = nullptr;
+		double EnqueueTime = 0.0;
+		EChunkTaskLane Lane = EChunkTaskLane::Near;
+		// Assign stage only, set once the chunk holds one of the stage's concurrency slots
+		bool bStarted = false;
+	};
+
+	struct FStage
+	{
+		FStageSettings Settings;
+
+		// Dispatch keeps the chunks it is working on in here too, Assign only the ones not picked up by Tick yet
+		TArray<FEntry> Queue;
+		int32 NumActive = 0;
+
+		int32 WindowCompleted = 0;
+		double WindowLatency = 0.0;
+		FStageStats Published;
+	};
+
+	// Chunk waiting for FlushDispatches
+	struct FPendingDispatch
+	{
+		UChunkObject* Chunk = nullptr;
+		FPlanetComputeShaderDispatchParams Params;
+	};
+
+	// Chunks between Surface and Assign, waiting for their parallel branches to finish
+	struct FJoin
+	{
+		int32 NumPending = 0;
+		bool bFailed = false;
+	};
+
+	static bool IsBranchStage(EChunkPipelineStage Stage);
+	// Index of the entry a stage starts next: the oldest Near one, or the oldest one if there is none
+	static int32 FindNextEntry(const TArray<FEntry>& Queue);
+
+	// All private functions expect CriticalSection to be locked, except TickAssign, Pump and FinishStage
+	bool CanStart(EChunkPipelineStage Stage) const;
+	int32 GetQueuedLocked(EChunkPipelineStage Stage) const;
+	int32 GetNumInFlightLocked() const;
+	void Enqueue(EChunkPipelineStage Stage, UChunkObject* Chunk, EChunkTaskLane Lane);
+	void RecordExit(EChunkPipelineStage Stage, double EnqueueTime);
+	// The chunk left the pipeline, it is no longer kept alive by it
+	void Release(UChunkObject* Chunk);
+
+	// Take a chunk out of the dispatch stage, into the readback stage if bReady
+	void LeaveDispatch(UChunkObject* Chunk, bool bReady);
+	// Game thread, from the dispatch callback of a batch. Weak since chunks dispatched before a reset are no longer kept alive.
+	void OnBatchDispatched(const TArray<TWeakObjectPtr<UChunkObject>>& Chunks, const TArray<FPlanetComputeShaderReadback>& Readbacks, uint32 InEpoch);
+
+	void TickDispatch();
+	void TickReadback();
+	// Game thread only, returns the number of chunks waiting for a slot
+	int32 TickAssign(int32 MaxAssigning, TArray<double>& OutFinishedEnqueueTimes);
+	void UpdateStats();
+
+	// Start every queued worker stage chunk that fits, any thread
+	void Pump();
+	void StartWorker(EChunkPipelineStage Stage, const FEntry& Entry);
+
+	// Called when the Readback or a worker stage is done with a chunk, any thread
+	void FinishStage(const FEntry& Entry, EChunkPipelineStage Stage, uint32 InEpoch, bool bSuccess);
+
+	const TSharedRef<FChunkTaskContext> TaskContext = MakeShared<FChunkTaskContext>();
+	const TSharedRef<FChunkReadbackQueue> ReadbackQueue = MakeShared<FChunkReadbackQueue>();
+
+	mutable FCriticalSection CriticalSection;
+	FStage Stages[static_cast<int32>(EChunkPipelineStage::Num)];
+	int32 MaxInFlight = MAX_int32;
+
+	// Every chunk that left Surface until its last branch is done
+	TMap<UChunkObject*, FJoin> Joins;
+
+	// Every chunk from Dispatch until it leaves the pipeline, once per dispatch. Reported to GC, so the raw pointers
+	// in the entries stay valid on the workers and the chunks are not collected while a stage uses them.
+	TArray<TObjectPtr<UChunkObject>> InFlightChunks;
+
+	// Assign stage chunks picked up by Tick, only touched on the game thread
+	TArray<FEntry> AssignEntries;
+
+	// Dispatched chunks not sent to the GPU yet, only touched on the game thread
+	TArray<FPendingDispatch> PendingDispatches;
+	int32 MaxBatchSize = 16;
+	FBatchDispatcher BatchDispatcher = &FPlanetComputeShaderInterface::DispatchBatch;
+
+	// Counts of AssignEntries as of the last Tick. Chunks held back by UChunkObject::bAssignHeld do not use up the queue.
+	int32 NumAssignWaiting = 0;
+	int32 NumAssignHeld = 0;
+
+	// Bumped by Reset so running work from before it is not counted
+	uint32 Epoch = 0;
+
+	double StatsWindowStart = 0.0;
+	static constexpr double StatsWindowSeconds = 1.0;
+};
@@ -0,0 +1,85 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2026 Maciej Tkaczewski
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "ComputeShader/Public/PlanetComputeShader/PlanetComputeShader.h"
+
+class UChunkObject;
+
+/**
+ * Owns the readbacks of dispatched chunks until the GPU is done with them.
+ * Readiness is checked once per batched dispatch, by a render command the pipeline enqueues every frame, instead of
+ * walking every waiting chunk. The chunks of ready batches are pushed into a multi-producer queue the pipeline drains.
+ */
+class PPG_API FChunkReadbackQueue : public TSharedFromThis<FChunkReadbackQueue>
+{
+public:
+	// Chunks are only passed through here, never dereferenced. The pipeline keeps them alive.
+	struct FCompletion
+	{
+		UChunkObject* Chunk = nullptr;
+		// From Watch to the poll that found the readback ready
+		double LatencySeconds = 0.0;
+	};
+
+	struct FStats
+	{
+		// Batches whose readback is not ready yet
+		int32 Outstanding = 0;
+		// Ready chunks not picked up by the pipeline yet
+		int32 Queued = 0;
+		// Averaged over the last stats window
+		double AverageLatencyMs = 0.0;
+		double AveragePollMs = 0.0;
+	};
+
+	// Game thread: track a chunk that just entered WAITING_FOR_GPU, the chunks of one batch are checked together
+	void Watch(UChunkObject* Chunk, const FPlanetComputeShaderReadback& Readback);
+
+	// Game thread: run Poll on the render thread, unless the last one has not run yet
+	void EnqueuePoll();
+
+	// Any thread: check every outstanding batch once and queue the chunks of the ready ones
+	void Poll();
+	// Same, with IsReady deciding in place of FPlanetComputeShaderReadback::IsReady
+	void Poll(TFunctionRef<bool(const FPlanetComputeShaderReadback& Readback)> IsReady);
+
+	// Single consumer
+	bool Dequeue(FCompletion& OutCompletion);
+
+	// Forget everything outstanding and queued
+	void Reset();
+
+	FStats GetStats() const;
+
+private:
+	struct FBatch
+	{
+		// Of the first chunk watched, the batch's chunks share its buffers
+		FPlanetComputeShaderReadback Readback;
+		TArray<UChunkObject*> Chunks;
+		double WatchTime = 0.0;
+	};
+
+	// Expects CriticalSection to be locked
+	void UpdateStats(double Now);
+
+	mutable FCriticalSection CriticalSection;
+
+	// Keyed by the buffers the chunks of a batch share
+	TMap<const void*, FBatch> Batches;
+	TQueue<FCompletion, EQueueMode::Mpsc> Completions;
+	int32 NumQueued = 0;
+	bool bPollPending = false;
+
+	int32 WindowCompleted = 0;
+	double WindowLatency = 0.0;
+	int32 WindowPolls = 0;
+	double WindowPollTime = 0.0;
+	double StatsWindowStart = 0.0;
+	FStats Published;
+	static constexpr double StatsWindowSeconds = 1.0;
+};
@@ -0,0 +1,48 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2026 Maciej Tkaczewski
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ChunkPipeline.h"
+
+class UChunkObject;
+
+/**
+ * Priority queue for chunks waiting to start GPU generation.
+ * Chunks are queued during the quadtree traversal and the best ones are started once per frame.
+ */
+struct PPG_API FChunkScheduler
+{
+public:
+	struct FRequest
+	{
+		UChunkObject* Chunk = nullptr;
+		float Priority = 0.0f;
+		EChunkTaskLane Lane = EChunkTaskLane::Near;
+	};
+
+	// Queue a PENDING_GENERATION chunk for this frame. Higher priority starts first, Lane is where its CPU work runs.
+	void Request(UChunkObject* Chunk, float Priority, EChunkTaskLane Lane = EChunkTaskLane::Near);
+
+	// Start up to MaxGenerations queued chunks (highest priority first) in Pipeline, as far as its capacity allows, then clear the queue
+	int32 Dispatch(int32 MaxGenerations, FChunkPipeline& Pipeline);
+
+	void Reset();
+
+	int32 Num() const { return Queue.Num(); }
+
+	// Valid requests that stayed in PENDING_GENERATION on the last Dispatch
+	int32 GetNumHeld() const { return NumHeld; }
+
+	/**
+	 * Priority is the approximate screen-space size of the chunk (edge length over distance to its surface),
+	 * so close chunks beat far ones and large chunks beat small ones at the same distance.
+	 * Chunks holding up a parent split or a child merge are boosted by BlockingScale.
+	 */
+	static float ComputePriority(double Distance, double ChunkSize, bool bBlocking, float BlockingScale);
+
+private:
+	TArray<FRequest> Queue;
+	int32 NumHeld = 0;
+};
@@ -0,0 +1,80 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2026 Maciej Tkaczewski
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tasks/Task.h"
+
+enum class EChunkTaskLane : uint8
+{
+	// Chunks the current view needs
+	Near,
+	// Prefetched chunks and chunks below the horizon
+	Background,
+	Num
+};
+
+/**
+ * Runs the chunk CPU work of a planet, instead of sending it straight to the engine's background pool.
+ * Caps the workers it occupies so terrain work cannot starve the game, and always starts queued Near tasks before
+ * Background ones. Background tasks have their own, lower cap and can be launched at background priority,
+ * which the task system runs on its lower OS priority workers.
+ */
+class PPG_API FChunkTaskContext : public TSharedFromThis<FChunkTaskContext>
+{
+public:
+	struct FSettings
+	{
+		// Tasks running at the same time across both lanes, 0 uses all but one of the engine's background workers
+		int32 MaxWorkers = 0;
+		// Of those, the ones the Background lane may take
+		int32 MaxBackgroundWorkers = 2;
+		bool bLowPriorityBackground = true;
+	};
+
+	struct FLaneStats
+	{
+		int32 Queued = 0;
+		int32 Running = 0;
+	};
+
+	void Configure(const FSettings& InSettings);
+
+	// Any thread
+	void Launch(EChunkTaskLane Lane, TUniqueFunction<void()> Task);
+
+	// Drop the queued tasks, running ones finish
+	void CancelQueued();
+
+	// Block until every running task has returned. Call after CancelQueued, and once nothing launches new tasks,
+	// before freeing anything the tasks use.
+	void FlushRunningTasks();
+
+	FLaneStats GetLaneStats(EChunkTaskLane Lane) const;
+
+private:
+	struct FPendingTask
+	{
+		EChunkTaskLane Lane = EChunkTaskLane::Near;
+		bool bLowPriority = false;
+		TUniqueFunction<void()> Task;
+	};
+
+	// All expect CriticalSection to be locked. Tasks are launched under it, so FlushRunningTasks sees every task
+	// as soon as it counts as running.
+	void StartRunnable();
+	// Moves the tasks that fit into OutTasks
+	void PopRunnable(TArray<FPendingTask>& OutTasks);
+	void StartTasks(TArray<FPendingTask>& Tasks);
+	void OnTaskFinished(EChunkTaskLane Lane);
+
+	int32 GetMaxWorkers() const;
+
+	mutable FCriticalSection CriticalSection;
+	FSettings Settings;
+	TArray<TUniqueFunction<void()>> Queues[static_cast<int32>(EChunkTaskLane::Num)];
+	int32 NumRunning[static_cast<int32>(EChunkTaskLane::Num)] = {};
+	// Launched tasks, completed ones are dropped lazily
+	TArray<UE::Tasks::FTask> RunningTasks;
+};
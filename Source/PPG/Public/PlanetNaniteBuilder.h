@@ -37,7 +37,8 @@ public:
 
 	// OutClusteredIndices will be filled only when compressing vertices;
 	// In other case, original indices array does represent clustered indices
-	TUniquePtr<FStaticMeshRenderData> CreateRenderData(bool& AbortAsync, bool RayTracingProxy, bool NaniteEnabled);
+	// Cluster, page and hierarchy building stop early and return null once ShouldCancel is set
+	TUniquePtr<FStaticMeshRenderData> CreateRenderData(const TVoxelAtomic<bool>& ShouldCancel, bool RayTracingProxy, bool NaniteEnabled);
 	UStaticMesh* CreateStaticMesh();
 
 public:
@@ -63,6 +64,9 @@ private:
 
 	bool Build(FBuildData& BuildData);
 
+	const TVoxelAtomic<bool>* CancelFlag = nullptr;
+	bool IsCancelled() const { return CancelFlag && CancelFlag->Get(std::memory_order_relaxed); }
+
 	TVoxelArray<TUniquePtr<FCluster>> CreateClusters() const;
 
 	Nanite::FResources Resources;
@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2026 Maciej Tkaczewski
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PlanetQualityGovernor.generated.h"
+
+// Bounds and response of FPlanetQualityGovernor
+USTRUCT(BlueprintType)
+struct FPlanetQualityGovernorSettings
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Governor")
+	bool bEnabled = false;
+
+	// Frame rate the governor holds by lowering the detail
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Governor", meta = (ClampMin = "1.0"))
+	float TargetFrameRate = 60.0f;
+
+	// Process memory (MB) above which the detail is lowered, 0 ignores memory
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Governor", meta = (ClampMin = "0"))
+	int32 MemoryBudgetMB = 0;
+
+	// Chunks the view needs that may wait for the GPU generation queue before the detail is lowered
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Governor", meta = (ClampMin = "1"))
+	int32 MaxChunkBacklog = 64;
+
+	// Generated chunks that may wait for game-thread finalization before the detail is lowered.
+	// Finalization time itself says nothing, the assign stage uses up its budget whenever it has work.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Governor", meta = (ClampMin = "1"))
+	int32 MaxFinalizeBacklog = 32;
+
+	// Range of the LOD bias, a bias of B scales split distances by 2^B
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Governor", meta = (ClampMax = "0.0"))
+	float MinLODBias = -2.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Governor", meta = (ClampMin = "0.0"))
+	float MaxLODBias = 1.0f;
+
+	// GlobalFoliageDensityScale at MinLODBias, rising to MaxFoliageDensityScale at a bias of 0
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Governor", meta = (ClampMin = "0.0"))
+	float MinFoliageDensityScale = 0.25f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Governor", meta = (ClampMin = "0.0"))
+	float MaxFoliageDensityScale = 1.0f;
+
+	// Time constant (seconds) of the smoothing applied to every measurement, keeps single hitches from moving the bias
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Governor", meta = (ClampMin = "0.0"))
+	float SmoothingTime = 1.0f;
+
+	// Detail is only raised while every measurement stays below this fraction of its target
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Governor", meta = (ClampMin = "0.1", ClampMax = "1.0"))
+	float Headroom = 0.8f;
+
+	// Bias change per second while over a target, and while below the headroom. Lowering faster than raising avoids oscillation.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Governor", meta = (ClampMin = "0.0"))
+	float DecreaseRate = 1.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Governor", meta = (ClampMin = "0.0"))
+	float IncreaseRate = 0.1f;
+
+	// The LOD only follows the bias in steps of this size, each step re-evaluates the whole quadtree
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Governor", meta = (ClampMin = "0.01"))
+	float BiasStep = 0.125f;
+};
+
+/**
+ * Trades planet detail for frame rate at runtime.
+ * Every frame it compares frame time, the chunks waiting for finalization, the generation backlog and memory use against
+ * their targets. The bias drops while any of them is over its target and rises slowly while all of them have headroom.
+ */
+struct PPG_API FPlanetQualityGovernor
+{
+public:
+	struct FSample
+	{
+		float DeltaTime = 0.0f;
+		// Generated chunks waiting in the assign stage
+		int32 FinalizeBacklog = 0;
+		// Chunks that wanted to start generation this frame and could not
+		int32 Backlog = 0;
+		uint64 UsedMemory = 0;
+	};
+
+	// Returns true when the applied bias changed, the LOD has to be re-evaluated then
+	bool Update(const FPlanetQualityGovernorSettings& Settings, const FSample& Sample);
+
+	void Reset();
+
+	// Bias the LOD currently uses, in steps of BiasStep
+	float GetLODBias() const { return AppliedBias; }
+	float GetLODDistanceScale() const { return LODDistanceScale; }
+	float GetFoliageDensityScale(const FPlanetQualityGovernorSettings& Settings) const;
+
+	// Largest smoothed measurement relative to its target, above 1 lowers the detail
+	float GetPressure() const { return Pressure; }
+
+private:
+	enum EMeasurement
+	{
+		FrameTime,
+		Finalize,
+		Backlog,
+		Memory,
+		NumMeasurements
+	};
+
+	float Smoothed[NumMeasurements] = {};
+	bool bHasSample = false;
+	float Pressure = 0.0f;
+
+	float Bias = 0.0f;
+	float AppliedBias = 0.0f;
+	float LODDistanceScale = 1.0f;
+};
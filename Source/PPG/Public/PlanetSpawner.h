@@ -6,6 +6,8 @@
 #include "CoreMinimal.h"
 
 #include "ChunkObject.h"
+#include "ChunkScheduler.h"
+#include "PlanetQualityGovernor.h"
 #include "GameFramework/Actor.h"
 #include "PlanetData.h"
 #include "AssetRegistry/AssetRegistryModule.h"
@@ -15,37 +17,439 @@
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnPlanetGenerationFinished);
 
-USTRUCT()
-struct FChunkTree
+USTRUCT(BlueprintType)
+struct FPlanetViewSource
 {
 	GENERATED_BODY()
+
+	// Actor whose eyes view point is used as an extra LOD view
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Views")
+	TWeakObjectPtr<AActor> Actor;
+
+	// Scales the view's split distances, below 1 asks for less detail
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Views", meta = (ClampMin = "0.0"))
+	float Weight = 1.0f;
+
+	// Field of view (degrees) for the screen-space error policy, 0 uses the current camera FOV
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Views", meta = (ClampMin = "0.0", ClampMax = "170.0"))
+	float FOVOverride = 0.0f;
+};
+
+// LOD state of one view in planet (actor) space
+struct FPlanetLODView
+{
+	FVector Location = FVector::ZeroVector;
+
+	// Where the view is expected to be PrefetchTimeHorizon seconds from now
+	FVector PredictedLocation = FVector::ZeroVector;
+
+	// Scales the view's split distances, 0 disables the view
+	float Weight = 0.0f;
+
+	// Viewport height in pixels over 2*tan(FOV/2), converts world size at a distance to pixels
+	float ProjectionScale = 0.0f;
+
+	// Record a location at world time Now and return the average velocity over the last HistoryDuration seconds.
+	// World time follows time dilation and pauses, so the prediction matches how fast the view moves in game.
+	FVector UpdateVelocity(const FVector& NewLocation, double Now, double HistoryDuration);
+
+private:
+	struct FSample
+	{
+		FVector Location;
+		double Time;
+	};
+	TArray<FSample> History;
+};
+
+// Concurrency and queue bound of one stage of the chunk generation pipeline
+USTRUCT(BlueprintType)
+struct FChunkPipelineStageSettings
+{
+	GENERATED_BODY()
+
+	FChunkPipelineStageSettings() = default;
+	FChunkPipelineStageSettings(int32 InMaxConcurrency, int32 InQueueCapacity)
+		: MaxConcurrency(InMaxConcurrency)
+		, QueueCapacity(InQueueCapacity)
+	{
+	}
+
+	// Chunks this stage works on at the same time
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Pipeline", meta = (ClampMin = "1"))
+	int32 MaxConcurrency = 4;
+
+	// Chunks allowed to wait for this stage, the stage before it stops starting new work while it is full
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Pipeline", meta = (ClampMin = "1"))
+	int32 QueueCapacity = 16;
+};
+
+// Counters of one stage of the chunk generation pipeline
+USTRUCT(BlueprintType)
+struct FChunkPipelineStageStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Pipeline")
+	int32 Queued = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Pipeline")
+	int32 Active = 0;
+
+	// Time from entering the stage's queue to leaving the stage, averaged over the last second
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Pipeline")
+	float AverageLatencyMs = 0.0f;
+
+	// Chunks leaving the stage per second
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Pipeline")
+	float Throughput = 0.0f;
+};
+
+// Counters of every stage of the chunk generation pipeline, in pipeline order
+USTRUCT(BlueprintType)
+struct FChunkPipelineStats
+{
+	GENERATED_BODY()
+
+	// Queued for generation but held back by the per-frame limit or by backpressure
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Pipeline")
+	int32 Held = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Pipeline")
+	FChunkPipelineStageStats Dispatch;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Pipeline")
+	FChunkPipelineStageStats Readback;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Pipeline")
+	FChunkPipelineStageStats Surface;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Pipeline")
+	FChunkPipelineStageStats Foliage;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Pipeline")
+	FChunkPipelineStageStats Collision;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Pipeline")
+	FChunkPipelineStageStats RenderData;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Pipeline")
+	FChunkPipelineStageStats Assign;
+
+	// Dispatched batches whose GPU readback is not ready yet
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Pipeline")
+	int32 ReadbacksOutstanding = 0;
+
+	// Chunks with a ready readback not moved on by the pipeline yet
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Pipeline")
+	int32 ReadbacksQueued = 0;
+
+	// Time from a chunk's dispatch callback to its readback being found ready
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Pipeline")
+	float ReadbackLatencyMs = 0.0f;
+
+	// Render thread time of one readiness check of all outstanding readbacks
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Pipeline")
+	float ReadbackPollMs = 0.0f;
+
+	// Readback buffers reused from the pool and newly created, shared by every planet
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Pipeline")
+	int64 ReadbackPoolHits = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Pipeline")
+	int64 ReadbackPoolMisses = 0;
+
+	// Bytes of the readback buffers in use and pooled
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Pipeline")
+	int64 ReadbackPoolBytesResident = 0;
+};
+
+// Progress of the generation that ends with OnPlanetGenerationFinished
+USTRUCT(BlueprintType)
+struct FPlanetGenerationProgress
+{
+	GENERATED_BODY()
+
+	// False once OnPlanetGenerationFinished was broadcast
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Loading")
+	bool bLoading = false;
+
+	// Generating without the gameplay frame limits, see bBulkGenerationWhileLoading
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Loading")
+	bool bBulk = false;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Loading")
+	int32 ChunksReady = 0;
+
+	// Chunks the current LOD needs. Grows while the tree still refines towards the view.
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Loading")
+	int32 ChunksRequired = 0;
+
+	// ChunksReady over ChunksRequired, 1 once loading is done
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Loading")
+	float Fraction = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Loading")
+	float ElapsedSeconds = 0.0f;
+
+	// From the rate chunks became ready at so far, negative until the first one is
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Loading")
+	float EstimatedSecondsRemaining = -1.0f;
+};
+
+UENUM(BlueprintType)
+enum class EChunkLODPolicy : uint8
+{
+	// Split when the view is closer to a chunk than its size
+	Distance UMETA(DisplayName="Distance"),
+	// Split when the chunk's projected geometric error exceeds TargetPixelError
+	ScreenSpaceError UMETA(DisplayName="Screen Space Error")
+};
+
+// How generated chunks are read back from the GPU, mirrors EPlanetReadbackFormat
+UENUM(BlueprintType)
+enum class EChunkReadbackFormat : uint8
+{
+	// Full float positions and RGBA8 colors, 16 bytes per vertex
+	Float UMETA(DisplayName="Float"),
+	// 16-bit height, positions rebuilt from the chunk grid. 6 bytes per vertex, heights in steps of NoiseHeight / 32768.
+	Compact16 UMETA(DisplayName="Compact (16-bit height)"),
+	// 24-bit height, positions rebuilt from the chunk grid. 8 bytes per vertex, heights in steps of NoiseHeight / 8388608.
+	Compact24 UMETA(DisplayName="Compact (24-bit height)")
+};
+
+// One quadtree node. Nodes live in FChunkTree::Nodes and refer to each other by index,
+// so the traversal walks a contiguous array instead of chasing heap pointers.
+struct FChunkTreeNode
+{
+	// Hot: read on every LOD evaluation
 	
-	// Child chunks
-	TSharedPtr<FChunkTree> Child1;
-	TSharedPtr<FChunkTree> Child2;
-	TSharedPtr<FChunkTree> Child3;
-	TSharedPtr<FChunkTree> Child4;
-	
-	UPROPERTY(Transient)
-	TObjectPtr<UChunkObject> ChunkObject = nullptr;
+	// Center on the sphere raised to MaxChunkHeight, refreshed on every evaluation
+	FVector WorldCenter = FVector::ZeroVector;
+	double ChunkSize = 0.0;
+
+	// Incremental LOD state: nothing in a settled subtree is in flight, and no split/merge decision
+	// in it can change before the view odometer advances SubtreeMargin past EvaluatedOdometer
+	double EvaluatedOdometer = 0.0;
+	double SubtreeMargin = 0.0;
+
+	// Last time (FPlatformTime::Seconds) a chunk in this subtree became READY, drives the merge residency hold
+	double LatestReadyTime = 0.0;
 	
 	// Height of the highest vertex in this chunk
 	float MaxChunkHeight = 0;
 
-	// Frame counter for delaying generation start (higher recursion = more delay)
-	int32 PendingFrames = 0;
+	// Roughness of the node's last generated chunk, see UChunkObject::HeightDeviation. Inherited from the closest
+	// generated ancestor until then, negative while nothing above the node was generated.
+	float HeightDeviation = -1.0f;
+	float MaxCurvature = -1.0f;
+
+	// Chunks in this subtree, including the node's own, kept up to date on attach/detach and status changes
+	int32 NumChunks = 0;
+	int32 NumReadyChunks = 0;
+	int32 NumInFlightChunks = 0;
+
+	// READY chunks still waiting for their refinement, see UChunkObject::bNeedsRefinement
+	int32 NumUnrefinedChunks = 0;
+
+	// Not-READY chunks that are the first configured chunk on their path down from this node.
+	// The node's own chunk counts as one if it is not READY, and hides everything below it.
+	int32 NumUnreadyFrontier = 0;
+
+	// Index of the first of four consecutive children, INDEX_NONE for leaves
+	int32 FirstChild = INDEX_NONE;
+	int32 Parent = INDEX_NONE;
+	int32 Level = 0;
+
+	bool bSubtreeSettled = false;
+	bool bCenterCached = false;
+
+	// Split on the last evaluation, selects the merge threshold instead of the split threshold
+	bool bSplit = false;
+
+	// Cold: only needed when the node's chunk is created
+	
+	// Unit-sphere direction of the chunk center, fixed for a given node
+	FVector CenterDirection = FVector::ZeroVector;
+
+	// Angle between CenterDirection and the farthest corner of the chunk
+	float AngularRadius = 0.0f;
+	FVector ChunkLocation = FVector::ZeroVector;
+	FIntVector ChunkRotation = FIntVector::ZeroValue;
+};
+
+// One game-thread operation on the tree, produced by the LOD planning phase
+struct FChunkTreeAction
+{
+	enum class EType : uint8
+	{
+		// Allocate the node's children, then plan and apply them right away
+		Split,
+		CreateChunk,
+		RequestGeneration,
+		DestroyChunk,
+		AbortChunk,
+		// Let a prefetched chunk into the pipeline's assign stage
+		ReleaseAssign,
+		PrefetchChildren,
+		FreeChildren,
+		// Generate the full quality replacement of a displayed preview or reduced quality chunk, and swap it in once it is ready
+		RefineChunk,
+		DestroyRefinement
+	};
+
+	EType Type = EType::CreateChunk;
+	int32 NodeIndex = INDEX_NONE;
+
+	// Split: ParentGeneratedNode handed to the new children
+	int32 ParentGeneratedNode = INDEX_NONE;
+
+	// RequestGeneration and RefineChunk: scheduler priority, PrefetchChildren: view distance
+	float Value = 0.0f;
+
+	// RequestGeneration and RefineChunk: the chunk is below the horizon, its CPU work runs in the background lane
+	bool bBackground = false;
+};
+
+// Output of a planning pass
+struct FChunkTreePlan
+{
+	TArray<FChunkTreeAction> Actions;
+
+	// Subtree roots (and their ParentGeneratedNode) left for the worker threads
+	TArray<TPair<int32, int32>> Subtrees;
+
+	// Split nodes above the worker subtrees, top-down, whose settled state is gathered after the workers finish
+	TArray<int32> DeferredNodes;
+
+	void Add(FChunkTreeAction::EType Type, int32 NodeIndex, int32 ParentGeneratedNode = INDEX_NONE, float Value = 0.0f, bool bBackground = false)
+	{
+		Actions.Add({ Type, NodeIndex, ParentGeneratedNode, Value, bBackground });
+	}
+};
+
+// Per-frame state shared by every planning task
+struct FChunkPlanContext
+{
+	APlanetSpawner* Planet = nullptr;
+	bool bGenerationMaterialReady = false;
+	double Now = 0.0;
+};
+
+USTRUCT()
+struct FChunkTree
+{
+	GENERATED_BODY()
+
+	static constexpr int32 NumFaces = 6;
+	
+	// Node pool. The first NumFaces entries are the cube face roots, the rest are blocks of four siblings.
+	TArray<FChunkTreeNode> Nodes;
+
+	// Chunk of each node, indexed like Nodes
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UChunkObject>> ChunkObjects;
+
+	// Full quality chunk being generated to replace the node's preview chunk, indexed like Nodes.
+	// Not attached, so it does not show up in the node counters until it is swapped in.
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UChunkObject>> RefineChunks;
+
+	// Refinements dropped while their generation was running, destroyed once they reach ABORTED
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UChunkObject>> RetiredChunks;
+
+	// Released child blocks, reused before the pool grows
+	TArray<int32> FreeBlocks;
+
+	// Rebuild the six face roots for the given planet
+	void Initialize(const UPlanetData& PlanetData);
 
-	void GenerateChunks(int RecursionLevel, FIntVector ChunkRotation, FVector ChunkLocation, double LocalChunkSize, APlanetSpawner* Planet, FChunkTree* ParentMesh);
+	bool IsInitialized() const { return Nodes.Num() >= NumFaces; }
+
+	// Plan the split/merge decisions of the whole tree (in parallel), then apply them on the game thread
+	void GenerateChunks(APlanetSpawner* Planet);
 	
-	// Traverse the tree and find chunks with non-empty ChunkObject
-	void FindConfiguredChunks(TArray<FChunkTree*>& Chunks, bool IncludeSelf, bool bFindFirst = true);
+	// Traverse the tree and find nodes with non-empty ChunkObject
+	void FindConfiguredChunks(int32 NodeIndex, TArray<int32>& Chunks, bool IncludeSelf, bool bFindFirst = true) const;
+
+	// Attach a chunk to an empty node, or detach it (the chunk is not destroyed) and update the subtree counters
+	void AttachChunk(int32 NodeIndex, UChunkObject* ChunkObject);
+	void DetachChunk(int32 NodeIndex);
+
+	// Called by UChunkObject::SetChunkStatus for attached chunks
+	void OnChunkStatusChanged(int32 NodeIndex, UChunkObject::EChunkStatus OldStatus, UChunkObject::EChunkStatus NewStatus);
 
-	// Delete all child chunks by resetting the unique pointers
+	// Cancel the in-flight work of every chunk in the subtree. Nothing is detached or destroyed, the chunks finish as ABORTED.
+	void CancelSubtree(int32 NodeIndex);
+	// Also cancels the refinements
+	void CancelAll();
+
+	// SelfDestruct every refinement, after CancelAll and a render flush
+	void DestroyRefinements();
+
+	// Whole planet counters, summed over the face roots
+	int32 GetNumChunks() const;
+	int32 GetNumReadyChunks() const;
+	int32 GetNumUnrefinedChunks() const;
+
+	// Force every node to be re-evaluated on the next traversal
+	void InvalidateSettled();
+
+	// Drop every node. Chunk objects must already be destroyed.
 	void Reset();
 
 	void AddReferencedObjects(FReferenceCollector& Collector);
-	
-	inline static int32 CompletionsThisFrame = 0;
+
+	// Chunks whose generation was started but that were destroyed or aborted before they were displayed
+	int32 WastedGenerations = 0;
+
+private:
+	// Planning only writes the LOD state of nodes in the planned subtree and reads everything else, chunk work goes to Plan.
+	// Children at SubtreeLevel and below are not visited but added to Plan.Subtrees.
+	void PlanChunks(int32 NodeIndex, const FChunkPlanContext& Context, int32 ParentGeneratedNode, int32 SubtreeLevel, FChunkTreePlan& Plan);
+
+	// Fold the settled state and margins of the node's children into the node
+	void GatherChildrenSettled(int32 NodeIndex, double ViewOdometer);
+
+	// Node references are invalidated whenever a child block is allocated, keep indices instead
+	void ApplyActions(TConstArrayView<FChunkTreeAction> Actions, const FChunkPlanContext& Context);
+
+	int32 AllocateChildren(int32 NodeIndex, const UPlanetData& PlanetData);
+
+	// Return the node's child blocks to the free list. Their chunks must already be destroyed.
+	void FreeChildren(int32 NodeIndex);
+
+	void CacheNodeBounds(int32 NodeIndex, const UPlanetData& PlanetData);
+
+	// Create a PENDING_GENERATION chunk for the node without attaching it, at the flat quality if the node is flat
+	UChunkObject* NewChunkObject(int32 NodeIndex, APlanetSpawner* Planet, bool bPreview);
+
+	// Create a PENDING_GENERATION chunk for the node and attach it, a preview one with bProgressiveRefinement
+	UChunkObject* CreateChunk(int32 NodeIndex, APlanetSpawner* Planet, bool bAllowPreview = true);
+
+	// Advance the node's refinement: create and request it, retry it after an abort, or swap it in once READY
+	void RefineChunk(int32 NodeIndex, APlanetSpawner* Planet, float Priority, EChunkTaskLane Lane);
+	void DestroyRefinement(int32 NodeIndex);
+
+	// Destroy retired refinements that reached ABORTED
+	void SweepRetiredChunks();
+
+	// Prefetching fills the four children of a leaf with chunks that stop at PENDING_ASSIGN until the leaf splits
+	bool CanPrefetchChildren(int32 NodeIndex) const;
+	void PrefetchChildren(int32 NodeIndex, APlanetSpawner* Planet, double Distance);
+
+	// SelfDestruct the node's chunk and its refinement, and detach it
+	void DestroyChunk(int32 NodeIndex);
+
+	// Abort a GENERATING chunk, the traversal destroys it once it reaches ABORTED
+	void AbortChunk(int32 NodeIndex);
+
+	// Add to the chunk counters of the node and all of its ancestors
+	void PropagateCounts(int32 NodeIndex, int32 ChunksDelta, int32 ReadyDelta, int32 InFlightDelta, int32 UnrefinedDelta);
+
+	// Recompute NumUnreadyFrontier from the node up, stopping at the first ancestor that is unaffected
+	void UpdateFrontier(int32 NodeIndex);
 };
 
 
@@ -85,6 +489,43 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Planet|Spawning")
 	float GetCurrentFOV();
 
+	UFUNCTION(BlueprintCallable, Category = "Planet|Spawning")
+	int32 GetCurrentViewportHeight();
+
+	// View distance (from the chunk's nearest edge) below which a chunk of the given grid and roughness splits under the screen-space error policy
+	double GetScreenSpaceSplitDistance(double ChunkSize, int32 Quality, float HeightDeviation, float ProjectionScale) const;
+
+	// True if a patch around Direction is hidden behind the planet from ViewLocation (planet space).
+	// OutMargin is how far the view can move without the answer changing, kept small while the view is close to the occluder.
+	bool IsBelowHorizon(const FVector& ViewLocation, const FVector& Direction, float AngularRadius, float MaxChunkHeight, double& OutMargin) const;
+
+	// Add an actor whose view point also drives the LOD, next to the player/editor view.
+	// Weight scales its split distances (below 1 asks for less detail), FOVOverride (degrees) replaces the camera FOV when above 0.
+	UFUNCTION(BlueprintCallable, Category = "Planet|Views")
+	void RegisterViewSource(AActor* Actor, float Weight = 1.0f, float FOVOverride = 0.0f);
+
+	UFUNCTION(BlueprintCallable, Category = "Planet|Views")
+	void UnregisterViewSource(AActor* Actor);
+
+	// Chunks generated (or started) and thrown away before they were displayed, since the tree was last rebuilt
+	UFUNCTION(BlueprintCallable, Category = "Planet|Performance")
+	int32 GetWastedGenerations() const;
+
+	UFUNCTION(BlueprintCallable, Category = "Planet|Performance")
+	FChunkPipelineStats GetPipelineStats() const;
+
+	// LOD bias the quality governor currently applies, split distances are scaled by 2^Bias. 0 while the governor is disabled.
+	UFUNCTION(BlueprintCallable, Category = "Planet|Performance")
+	float GetLODBias() const;
+
+	// For loading screens, until OnPlanetGenerationFinished
+	UFUNCTION(BlueprintCallable, Category = "Planet|Loading")
+	FPlanetGenerationProgress GetGenerationProgress() const;
+
+	// True while loading in a game world with bBulkGenerationWhileLoading
+	UFUNCTION(BlueprintCallable, Category = "Planet|Loading")
+	bool IsBulkGenerating() const;
+
 private:
 	/** Generates CurveAtlas texture from unique TerrainCurve assets */
 	void GenerateCurveAtlas();
@@ -92,6 +533,15 @@ private:
 	/** Generates GPUBiomeData texture containing per-biome configuration */
 	void GenerateGPUBiomeData();
 
+	// Push the pipeline stage settings to ChunkPipeline, or the bulk ones while IsBulkGenerating
+	void ConfigurePipeline();
+
+	// Feed this frame's measurements to QualityGovernor and apply its bias
+	void UpdateQualityGovernor(float DeltaTime);
+
+	// Index buffer of a chunk grid with Quality quads per edge
+	static void BuildGridTriangles(int32 Quality, TArray<uint32>& OutTriangles);
+
 protected:
 	virtual void BeginPlay() override;
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
@@ -132,6 +582,43 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Planet|Setup")
 	int32 ChunkQuality = 191;
 
+	// Show new chunks as a quick low resolution preview first, then replace each one in place with a full ChunkQuality chunk.
+	// Foliage and collision only come with the full quality chunk. Prefetched chunks and bulk generation skip the preview.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Setup")
+	bool bProgressiveRefinement = false;
+
+	// ChunkQuality of preview chunks is divided by this
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Planet|Setup", meta = (ClampMin = "2", EditCondition = "bProgressiveRefinement"))
+	int32 PreviewQualityDivisor = 4;
+
+	int32 GetPreviewQuality() const;
+
+	// Generate chunks of flat terrain with fewer vertices, and let flat regions stop subdividing earlier.
+	// Flatness is measured on every generated chunk and estimated from the parent's chunk before that.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Setup")
+	bool bAdaptiveChunkQuality = false;
+
+	// ChunkQuality of flat chunks is divided by this
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Planet|Setup", meta = (ClampMin = "2", EditCondition = "bAdaptiveChunkQuality"))
+	int32 FlatQualityDivisor = 4;
+
+	// A chunk is flat if the standard deviation of its vertex heights is below this (cm)...
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Setup", meta = (ClampMin = "0", EditCondition = "bAdaptiveChunkQuality"))
+	float FlatMaxHeightDeviation = 1000.0f;
+
+	// ...and the flat quality grid would not deviate from the full quality surface by more than this (cm)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Setup", meta = (ClampMin = "0", EditCondition = "bAdaptiveChunkQuality"))
+	float FlatMaxSurfaceError = 25.0f;
+
+	// Split distance multiplier for flat chunks
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Setup", meta = (ClampMin = "0.1", ClampMax = "1", EditCondition = "bAdaptiveChunkQuality"))
+	float FlatSplitDistanceScale = 0.5f;
+
+	int32 GetFlatQuality() const;
+
+	// Whether a chunk with this roughness is generated at GetFlatQuality, false while the roughness is unknown
+	bool IsFlatChunk(float HeightDeviation, float MaxCurvature, double ChunkSize) const;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Setup")
 	bool bGenerateCollisions = true;
 
@@ -150,6 +637,9 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Setup")
 	bool bNaniteLandscape = true;
 
+	// Whether a generated chunk of this size is to be replaced by a full quality one
+	bool NeedsRefinement(const UChunkObject& ChunkObject, double ChunkSize) const;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Setup")
 	float GlobalFoliageDensityScale = 1.0f;
 
@@ -159,12 +649,169 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Water")
 	TObjectPtr<UStaticMesh> CloseWaterMesh;
 
+	// Game-thread time (ms) per frame for finishing generated chunks: mesh creation, components, foliage and water.
+	// Shared by all planets, one finalization step still runs per frame when it is exceeded.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Performance", meta = (ClampMin = "0.1"))
+	float ChunkFinalizationBudgetMs = 2.0f;
+
+	// Extra views the LOD refines for, e.g. split-screen players, cinematic cameras or server-side players
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Views")
+	TArray<FPlanetViewSource> ViewSources;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Performance")
+	EChunkLODPolicy LODPolicy = EChunkLODPolicy::Distance;
+
+	// Largest geometric error a chunk may show on screen before it splits, in pixels
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Performance", meta = (ClampMin = "0.1", EditCondition = "LODPolicy == EChunkLODPolicy::ScreenSpaceError"))
+	float TargetPixelError = 2.0f;
+
+	// Only re-evaluate quadtree nodes whose LOD decision could have changed since they were last visited
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Performance")
+	bool bIncrementalLOD = true;
+
+	// Split distance multiplier for chunks that are not split yet
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Performance", meta = (ClampMin = "0.1"))
+	float SplitDistanceScale = 1.0f;
+
+	// Split distance multiplier for chunks that are already split, above SplitDistanceScale keeps views near a LOD boundary from flipping it
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Performance", meta = (ClampMin = "0.1"))
+	float MergeDistanceScale = 1.2f;
+
+	// Seconds a split chunk is kept after one of its children became READY before it may merge again
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Performance", meta = (ClampMin = "0.0"))
+	float MinChunkResidencyTime = 1.0f;
+
+	// Plan the quadtree LOD on worker threads, only chunk creation and destruction stay on the game thread
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Performance")
+	bool bParallelLODPlanning = true;
+
+	// Recursion level whose subtrees are planned as separate worker tasks, 0 plans each cube face as one task
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Performance", meta = (ClampMin = "0", ClampMax = "6", EditCondition = "bParallelLODPlanning"))
+	int32 ParallelPlanningLevel = 2;
+
+	// View movement (in planet space) below this distance does not update the LOD view location
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Performance", meta = (ClampMin = "0.0", EditCondition = "bIncrementalLOD"))
+	float LODUpdateDistanceThreshold = 100.0f;
+
+	// How many pending chunks may start GPU generation per frame, picked by priority
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Performance", meta = (ClampMin = "1"))
+	int32 MaxChunkGenerationsPerFrame = 8;
+
+	// Chunks allowed between the GPU dispatch and PENDING_ASSIGN, bounds render target and readback memory
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Performance", meta = (ClampMin = "1"))
+	int32 MaxInFlightGenerations = 32;
+
+	// Chunks of the same size generated by one compute dispatch, sharing its material setup and readback. 1 dispatches every chunk on its own.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Pipeline", meta = (ClampMin = "1"))
+	int32 MaxChunksPerDispatch = 16;
+
+	// Vertex data layout read back from the GPU. The compact formats cut readback and copy volume to a half or less.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Pipeline")
+	EChunkReadbackFormat ReadbackFormat = EChunkReadbackFormat::Float;
+
+	// Readback buffers (MB, in use and pooled) above which finished ones are freed instead of reused by later dispatches.
+	// The pool is shared by every planet, the largest value of all planets applies. 0 disables reuse unless another planet has it on.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Pipeline", meta = (ClampMin = "0"))
+	int32 ReadbackPoolHighWaterMarkMB = 64;
+
+	// Mapping of the GPU readback buffers on the render thread. Chunks hold their batch's buffers mapped until their surface is processed.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Pipeline")
+	FChunkPipelineStageSettings ReadbackStage = { 8, 32 };
+
+	// Vertex, normal and slope processing on workers
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Pipeline")
+	FChunkPipelineStageSettings SurfaceStage = { 8, 16 };
+
+	// Foliage placement on workers, side by side with the collision cook and the render data build of the same chunk
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Pipeline")
+	FChunkPipelineStageSettings FoliageStage = { 4, 16 };
+
+	// Chaos collision cooking on workers
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Pipeline")
+	FChunkPipelineStageSettings CollisionStage = { 4, 16 };
+
+	// Nanite render data build on workers
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Pipeline")
+	FChunkPipelineStageSettings RenderDataStage = { 4, 16 };
+
+	// Game-thread finalization, chunks finalized side by side within ChunkFinalizationBudgetMs.
+	// The queue capacity also bounds the chunks between the surface stage and this one.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Pipeline")
+	FChunkPipelineStageSettings AssignStage = { 4, 16 };
+
+	// Background workers the chunk worker stages may occupy at once, 0 uses all but one of the engine's
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Pipeline", meta = (ClampMin = "0"))
+	int32 MaxChunkWorkers = 0;
+
+	// Of those, the ones prefetched and below-horizon chunks may take. Chunks the view needs always go first.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Pipeline", meta = (ClampMin = "1"))
+	int32 MaxBackgroundChunkWorkers = 2;
+
+	// Run prefetched and below-horizon chunks on the engine's lowest OS priority workers
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Pipeline")
+	bool bLowPriorityBackgroundChunks = true;
+
+	// Until OnPlanetGenerationFinished, usually behind a loading screen: no per-frame dispatch limit, no stage limits,
+	// every background worker and a larger finalization budget. Game worlds only, the editor keeps the gameplay limits.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Loading")
+	bool bBulkGenerationWhileLoading = true;
+
+	// Game-thread time (ms) per frame for finishing chunks in bulk mode, in place of ChunkFinalizationBudgetMs
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Loading", meta = (ClampMin = "0.1", EditCondition = "bBulkGenerationWhileLoading"))
+	float BulkFinalizationBudgetMs = 16.0f;
+
+	// Chunks allowed between the GPU dispatch and PENDING_ASSIGN in bulk mode, in place of MaxInFlightGenerations
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Loading", meta = (ClampMin = "1", EditCondition = "bBulkGenerationWhileLoading"))
+	int32 BulkMaxInFlightGenerations = 128;
+
+	// Lowers the LOD and the foliage density when the frame rate, the chunk finalization, the generation backlog or memory
+	// are over their targets, and raises them again when there is headroom. While enabled it drives GlobalFoliageDensityScale.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Performance")
+	FPlanetQualityGovernorSettings QualityGovernorSettings;
+
+	// Priority multiplier for chunks that a displayed parent or displayed children are waiting on
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Performance", meta = (ClampMin = "1.0"))
+	float BlockingChunkPriorityScale = 4.0f;
+
+	// Stop refining chunks hidden behind the planet's horizon
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Performance")
+	bool bHorizonCulling = true;
+
+	// Chunks below the horizon are still split down to this recursion level
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Performance", meta = (ClampMin = "0", EditCondition = "bHorizonCulling"))
+	int32 HorizonCullingMinLevel = 2;
+
+	// Generate children of chunks the view is about to need, based on its recent velocity
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Performance")
-	int32 MaxChunkCompletionsPerFrame = 2;
+	bool bPredictivePrefetch = true;
+
+	// How far ahead (seconds) the view trajectory is extrapolated
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Performance", meta = (ClampMin = "0.0", EditCondition = "bPredictivePrefetch"))
+	float PrefetchTimeHorizon = 2.0f;
+
+	// Length (seconds) of the view history used to estimate velocity
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Performance", meta = (ClampMin = "0.05", EditCondition = "bPredictivePrefetch"))
+	float PrefetchHistoryDuration = 0.5f;
+
+	// Priority multiplier for prefetched chunks, keeps them behind everything the current view needs
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Performance", meta = (ClampMin = "0.0", ClampMax = "1.0", EditCondition = "bPredictivePrefetch"))
+	float PrefetchPriorityScale = 0.05f;
+
+	// Priority multiplier for pending chunks below the horizon
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Performance", meta = (ClampMin = "0.0", ClampMax = "1.0", EditCondition = "bHorizonCulling"))
+	float OccludedChunkPriorityScale = 0.1f;
 
 	UPROPERTY()
 	TArray<uint32> Triangles;
 
+	// Triangles of the preview chunks' grid, see GetPreviewQuality
+	UPROPERTY()
+	TArray<uint32> PreviewTriangles;
+
+	// Triangles of the flat chunks' grid, see GetFlatQuality
+	UPROPERTY()
+	TArray<uint32> FlatTriangles;
+
 	UPROPERTY(BlueprintReadOnly, Category = "Planet|Internal")
 	uint8 MaterialLayersNum = 0;
 	
@@ -181,13 +828,30 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Collision")
 	FCollisionResponseContainer CollisionSetup;
 	
-	FVector ViewLocation;
+	// LOD state of the primary view followed by every registered view source, rebuilt in BuildPlanet
+	TArray<FPlanetLODView> LODViews;
+
+	// Total distance the LOD view location has travelled, used by the incremental LOD margins
+	double ViewOdometer = 0.0;
+
+	// Hash of the settings the split/merge decisions depend on, settled subtrees are re-evaluated when it changes
+	uint32 LODSettingsHash = 0;
+	uint32 ComputeLODSettingsHash() const;
+
+	// ReadbackPoolHighWaterMarkMB as last handed to the readback pool, INDEX_NONE while this planet has none set
+	int32 AppliedReadbackPoolHighWaterMarkMB = INDEX_NONE;
+
+	FChunkScheduler ChunkScheduler;
+	TSharedRef<FChunkPipeline> ChunkPipeline = MakeShared<FChunkPipeline>();
+	FPlanetQualityGovernor QualityGovernor;
 	bool bIsLoading = true;
+	// When the current loading started, 0 until the first tick of it
+	double LoadingStartTime = 0.0;
 	bool bIsRegenerating = false;
 	bool bRegenerateWhenMaterialReady = false;
 
 private:
-	FChunkTree ChunkTree1, ChunkTree2, ChunkTree3, ChunkTree4, ChunkTree5, ChunkTree6;
+	FChunkTree ChunkTree;
 
 	UPROPERTY(Transient)
 	TObjectPtr<AActor> FoliageActor;
@@ -53,11 +53,17 @@ struct Chaos::FTriangleMeshOverlapVisitorNoMTD<void>
 	static TRefCountPtr<FTriangleMeshImplicitObject> CookTriangleMesh(
 		const TConstVoxelArrayView<int32> Indices,
 		const TConstVoxelArrayView<FVector3f> Vertices,
-		const TConstVoxelArrayView<uint16> FaceMaterials)
+		const TConstVoxelArrayView<uint16> FaceMaterials,
+		const TVoxelAtomic<bool>* ShouldCancel)
 	{
 		VOXEL_FUNCTION_COUNTER_NUM(Vertices.Num());
 		checkVoxelSlow(Indices.Num() > 0);
 
+		const auto IsCancelled = [&]
+		{
+			return ShouldCancel && ShouldCancel->Get(std::memory_order_relaxed);
+		};
+
 		using IndexType = std::conditional_t<bUseLargeIndices, int32, uint16>;
 
 		TParticles<FRealSingle, 3> Particles;
@@ -82,6 +88,12 @@ struct Chaos::FTriangleMeshOverlapVisitorNoMTD<void>
 
 			for (int32 Index = 0; Index < NumTriangles; Index++)
 			{
+				if (Index % 4096 == 0 &&
+					IsCancelled())
+				{
+					return {};
+				}
+
 				const TVector<int32, 3> Triangle
 				{
 					Indices[3 * Index + 2],
@@ -152,6 +164,12 @@ struct Chaos::FTriangleMeshOverlapVisitorNoMTD<void>
 
 				for (int32 Index = 0; Index < Triangles.Num(); Index++)
 				{
+					if (Index % 4096 == 0 &&
+						IsCancelled())
+					{
+						return {};
+					}
+
 					const TVector<IndexType, 3>& Triangle = Triangles[Index];
 					const FVector3f VertexA = Vertices[Triangle.X];
 					const FVector3f VertexB = Vertices[Triangle.Y];
@@ -171,6 +189,11 @@ struct Chaos::FTriangleMeshOverlapVisitorNoMTD<void>
 			Tree.Initialize(MoveTemp(Elements));
 		}
 
+		if (IsCancelled())
+		{
+			return {};
+		}
+
 		VOXEL_SCOPE_COUNTER("FTriangleMeshImplicitObject");
 
 		const TRefCountPtr<FTriangleMeshImplicitObject> Result = new FTriangleMeshImplicitObject();
@@ -256,6 +279,11 @@ struct Chaos::FTriangleMeshOverlapVisitorNoMTD<void>
 
 			while (NodesToVisit.Num() > 0)
 			{
+				if (IsCancelled())
+				{
+					return;
+				}
+
 				const int32 NodeIndex = NodesToVisit.Pop();
 				const FVoxelAABBTree::FNode& Node = Nodes[NodeIndex];
 				checkVoxelSlow(!Node.bLeaf);
@@ -328,6 +356,11 @@ struct Chaos::FTriangleMeshOverlapVisitorNoMTD<void>
 			}
 		};
 
+		if (IsCancelled())
+		{
+			return {};
+		}
+
 		return Result;
 	}
 };
@@ -339,7 +372,8 @@ struct Chaos::FTriangleMeshOverlapVisitorNoMTD<void>
 TRefCountPtr<Chaos::FTriangleMeshImplicitObject> FVoxelChaosTriangleMeshCooker::Create(
 	const TConstVoxelArrayView<int32> Indices,
 	const TConstVoxelArrayView<FVector3f> Vertices,
-	const TConstVoxelArrayView<uint16> FaceMaterials)
+	const TConstVoxelArrayView<uint16> FaceMaterials,
+	const TVoxelAtomic<bool>* ShouldCancel)
 {
 	VOXEL_FUNCTION_COUNTER();
 	ensure(FaceMaterials.Num() == 0 || FaceMaterials.Num() == Indices.Num() / 3);
@@ -354,11 +388,11 @@ TRefCountPtr<Chaos::FTriangleMeshImplicitObject> FVoxelChaosTriangleMeshCooker::
 
 	if (Vertices.Num() < MAX_uint16)
 	{
-		return FCooker::CookTriangleMesh<false>(Indices, Vertices, FaceMaterials);
+		return FCooker::CookTriangleMesh<false>(Indices, Vertices, FaceMaterials, ShouldCancel);
 	}
 	else
 	{
-		return FCooker::CookTriangleMesh<true>(Indices, Vertices, FaceMaterials);
+		return FCooker::CookTriangleMesh<true>(Indices, Vertices, FaceMaterials, ShouldCancel);
 	}
 }
 
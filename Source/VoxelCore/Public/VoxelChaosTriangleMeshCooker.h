@@ -9,7 +9,9 @@ struct VOXELCORE_API FVoxelChaosTriangleMeshCooker
 	static TRefCountPtr<Chaos::FTriangleMeshImplicitObject> Create(
 		TConstVoxelArrayView<int32> Indices,
 		TConstVoxelArrayView<FVector3f> Vertices,
-		TConstVoxelArrayView<uint16> FaceMaterials);
+		TConstVoxelArrayView<uint16> FaceMaterials,
+		// Polled inside the cooking loops, returns null once set
+		const TVoxelAtomic<bool>* ShouldCancel = nullptr);
 
 	static int64 GetAllocatedSize(const Chaos::FTriangleMeshImplicitObject& TriangleMesh);
 };
\ No newline at end of file